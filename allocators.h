@@ -0,0 +1,262 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Аллокаторы для RawMemory и Vector, работающие напрямую с malloc и mmap
+
+// Размер большой страницы (Transparent Huge Pages) на x86-64 и AArch64 с 4 КиБ страницами
+inline constexpr size_t kHugePageSize = size_t{2} << 20;
+
+// Округляет размер вверх до целого числа страниц
+inline size_t RoundUpToPageSize(size_t bytes) noexcept {
+    static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return (bytes + page_size - 1) / page_size * page_size;
+}
+
+// Выделяет блоки до MmapThreshold байт через malloc, а более крупные отображает анонимным mmap.
+// Поддерживает reallocate: средние блоки растут через realloc, крупные — через mremap, при котором
+// ядро переносит страницы без копирования и не держит одновременно старый и новый буфер
+template <typename T, size_t MmapThreshold = size_t{64} << 20>
+class ReallocAllocator {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "malloc does not guarantee over-aligned storage");
+
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    template <typename U>
+    struct rebind {
+        using other = ReallocAllocator<U, MmapThreshold>;
+    };
+
+    ReallocAllocator() = default;
+
+    template <typename U>
+    ReallocAllocator(const ReallocAllocator<U, MmapThreshold>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        if (n > SIZE_MAX / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(IsMapped(n) ? Map(n * sizeof(T)) : Malloc(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        if (IsMapped(n)) {
+            munmap(static_cast<void*>(p), RoundUpToPageSize(n * sizeof(T)));
+        }
+        else {
+            std::free(static_cast<void*>(p));
+        }
+    }
+
+    // Меняет размер блока p с old_n на new_n элементов, сохраняя побайтово первые min(old_n, new_n)
+    T* reallocate(T* p, size_t old_n, size_t new_n) {
+        if (new_n > SIZE_MAX / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        const size_t old_bytes = old_n * sizeof(T);
+        const size_t new_bytes = new_n * sizeof(T);
+        if (!IsMapped(old_n) && !IsMapped(new_n)) {
+            void* result = std::realloc(static_cast<void*>(p), new_bytes);
+            if (result == nullptr) {
+                throw std::bad_alloc();
+            }
+            return static_cast<T*>(result);
+        }
+#ifdef __linux__
+        if (IsMapped(old_n) && IsMapped(new_n)) {
+            void* result = mremap(static_cast<void*>(p), RoundUpToPageSize(old_bytes), RoundUpToPageSize(new_bytes), MREMAP_MAYMOVE);
+            if (result == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            return static_cast<T*>(result);
+        }
+#endif
+        // Блок переходит через порог либо mremap недоступен: копируем в новый блок
+        T* result = allocate(new_n);
+        std::memcpy(static_cast<void*>(result), static_cast<const void*>(p), std::min(old_bytes, new_bytes));
+        deallocate(p, old_n);
+        return result;
+    }
+
+    template <typename U>
+    bool operator==(const ReallocAllocator<U, MmapThreshold>&) const noexcept {
+        return true;
+    }
+
+private:
+    static bool IsMapped(size_t n) noexcept {
+        return n * sizeof(T) >= MmapThreshold;
+    }
+
+    static void* Malloc(size_t bytes) {
+        void* result = std::malloc(bytes);
+        if (result == nullptr) {
+            throw std::bad_alloc();
+        }
+        return result;
+    }
+
+    static void* Map(size_t bytes) {
+        void* result = mmap(nullptr, RoundUpToPageSize(bytes), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (result == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        return result;
+    }
+};
+
+// Блоки от HugePageThreshold байт отображаются анонимным mmap с выравниванием на 2 МиБ и помечаются
+// MADV_HUGEPAGE, чтобы ядро подложило под них большие страницы и сократило промахи TLB.
+// Populate заранее отображает все страницы, перенося page fault'ы из горячего цикла в момент выделения.
+// Если THP недоступны, madvise завершается ошибкой и блок остаётся на обычных страницах.
+// Меньшие блоки выделяются std::allocator
+template <typename T, size_t HugePageThreshold = kHugePageSize, bool Populate = false>
+class HugePageAllocator {
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    template <typename U>
+    struct rebind {
+        using other = HugePageAllocator<U, HugePageThreshold, Populate>;
+    };
+
+    HugePageAllocator() = default;
+
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U, HugePageThreshold, Populate>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        if (!IsMapped(n)) {
+            return std::allocator<T>().allocate(n);
+        }
+        if (n > (SIZE_MAX - 2 * kHugePageSize) / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(MapHugePages(MappedSize(n)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        if (IsMapped(n)) {
+            munmap(static_cast<void*>(p), MappedSize(n));
+        }
+        else {
+            std::allocator<T>().deallocate(p, n);
+        }
+    }
+
+    template <typename U>
+    bool operator==(const HugePageAllocator<U, HugePageThreshold, Populate>&) const noexcept {
+        return true;
+    }
+
+private:
+    static bool IsMapped(size_t n) noexcept {
+        return n * sizeof(T) >= HugePageThreshold;
+    }
+
+    static size_t MappedSize(size_t n) noexcept {
+        return (n * sizeof(T) + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    }
+
+    static void* MapHugePages(size_t bytes) {
+        // mmap гарантирует выравнивание только на обычную страницу, поэтому отображаем
+        // с запасом в одну большую страницу и отрезаем невыровненные края
+        const size_t reserved = bytes + kHugePageSize;
+        void* raw = mmap(nullptr, reserved, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        char* begin = static_cast<char*>(raw);
+        char* aligned = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(begin) + kHugePageSize - 1)
+                                                & ~(uintptr_t{kHugePageSize} - 1));
+        if (aligned != begin) {
+            munmap(begin, aligned - begin);
+        }
+        munmap(aligned + bytes, begin + reserved - (aligned + bytes));
+#ifdef MADV_HUGEPAGE
+        (void)madvise(aligned, bytes, MADV_HUGEPAGE);
+#endif
+        if constexpr (Populate) {
+            PrefaultPages(aligned, bytes);
+        }
+        return aligned;
+    }
+
+    static void PrefaultPages(char* p, size_t bytes) noexcept {
+#ifdef MADV_POPULATE_WRITE
+        if (madvise(p, bytes, MADV_POPULATE_WRITE) == 0) {
+            return;
+        }
+#endif
+        const size_t page_size = RoundUpToPageSize(1);
+        for (size_t offset = 0; offset < bytes; offset += page_size) {
+            static_cast<volatile char*>(p)[offset] = 0;
+        }
+    }
+};
+
+// Размер кэш-линии на распространённых x86-64 и AArch64 процессорах
+inline constexpr size_t kCacheLineSize = 64;
+
+// Выделяет блоки, начинающиеся на границе Alignment байт (например, кэш-линии или 64 байт для AVX-512),
+// через выравнивающий operator new. Размер блока округляется до кратного Alignment, поэтому
+// полноширинная векторная загрузка хвоста не выходит за пределы выделенной памяти.
+// Типы с alignof(T) > Alignment получают собственное выравнивание.
+// std::allocator и без этого учитывает alignof(T), так что для over-aligned T достаточно его
+template <typename T, size_t Alignment = kCacheLineSize>
+class AlignedAllocator {
+    static_assert(std::has_single_bit(Alignment), "Alignment must be a power of two");
+
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    static constexpr size_t kAlignment = std::max(Alignment, alignof(T));
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        if (n > (SIZE_MAX - kAlignment) / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(::operator new(AllocationSize(n), std::align_val_t{kAlignment}));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        ::operator delete(static_cast<void*>(p), AllocationSize(n), std::align_val_t{kAlignment});
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept {
+        return true;
+    }
+
+private:
+    static size_t AllocationSize(size_t n) noexcept {
+        return (n * sizeof(T) + kAlignment - 1) / kAlignment * kAlignment;
+    }
+};
\ No newline at end of file
@@ -0,0 +1,198 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+// Монотонная арена для короткоживущих векторов, например всех временных векторов одного запроса.
+// Память выделяется сдвигом указателя в текущем блоке, а блоки берутся у malloc и растут вдвое.
+// Освобождение отдельного блока памяти ничего не делает, кроме случая, когда он выделен последним:
+// тогда указатель сдвигается назад, и этот же верхний блок может расти на месте.
+// Вся память возвращается разом через Reset или при уничтожении арены.
+// Арена не потокобезопасна: у каждого потока своя арена, например Arena::ThreadLocal()
+
+inline constexpr size_t kDefaultArenaChunkBytes = size_t{64} << 10;
+inline constexpr size_t kMaxArenaChunkBytes = size_t{16} << 20;
+
+class Arena {
+public:
+    explicit Arena(size_t chunk_bytes = kDefaultArenaChunkBytes) noexcept
+        : next_chunk_bytes_(std::max(chunk_bytes, sizeof(ChunkHeader)))
+    {
+    }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    ~Arena() {
+        FreeChunksExcept(nullptr);
+    }
+
+    // Арена текущего потока, создаваемая при первом обращении
+    static Arena& ThreadLocal() {
+        thread_local Arena arena;
+        return arena;
+    }
+
+    void* Allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+        assert(std::has_single_bit(alignment));
+        if (bytes > SIZE_MAX / 2) {
+            throw std::bad_alloc();
+        }
+        const size_t padding = (0 - reinterpret_cast<uintptr_t>(top_)) & (alignment - 1);
+        if (top_ == nullptr || bytes + padding > static_cast<size_t>(end_ - top_)) {
+            AddChunk(bytes + alignment);
+            return Allocate(bytes, alignment);
+        }
+        char* result = top_ + padding;
+        top_ = result + bytes;
+        return result;
+    }
+
+    // Возвращает память, только если p — последний выделенный блок
+    void Deallocate(void* p, size_t bytes) noexcept {
+        if (static_cast<char*>(p) + bytes == top_) {
+            top_ = static_cast<char*>(p);
+        }
+    }
+
+    // Меняет размер последнего выделенного блока p, не перемещая его. Возвращает false,
+    // если блок не последний или новый размер не помещается в текущий блок арены
+    bool ResizeInPlace(void* p, size_t old_bytes, size_t new_bytes) noexcept {
+        char* begin = static_cast<char*>(p);
+        if (begin + old_bytes != top_ || new_bytes > static_cast<size_t>(end_ - begin)) {
+            return false;
+        }
+        top_ = begin + new_bytes;
+        return true;
+    }
+
+    // Освобождает всю выделенную память. Самый большой блок арены остаётся
+    // для следующих выделений, остальные возвращаются malloc
+    void Reset() noexcept {
+        if (current_ == nullptr) {
+            return;
+        }
+        ChunkHeader* largest = current_;
+        for (ChunkHeader* chunk = current_->previous; chunk != nullptr; chunk = chunk->previous) {
+            if (chunk->bytes > largest->bytes) {
+                largest = chunk;
+            }
+        }
+        FreeChunksExcept(largest);
+        largest->previous = nullptr;
+        current_ = largest;
+        top_ = reinterpret_cast<char*>(largest + 1);
+        end_ = reinterpret_cast<char*>(largest) + largest->bytes;
+    }
+
+private:
+    struct alignas(std::max_align_t) ChunkHeader {
+        ChunkHeader* previous;
+        size_t bytes;
+    };
+
+    void AddChunk(size_t min_bytes) {
+        const size_t bytes = std::max(next_chunk_bytes_, sizeof(ChunkHeader) + min_bytes);
+        auto* chunk = static_cast<ChunkHeader*>(std::malloc(bytes));
+        if (chunk == nullptr) {
+            throw std::bad_alloc();
+        }
+        chunk->previous = current_;
+        chunk->bytes = bytes;
+        current_ = chunk;
+        top_ = reinterpret_cast<char*>(chunk + 1);
+        end_ = reinterpret_cast<char*>(chunk) + bytes;
+        next_chunk_bytes_ = std::min(next_chunk_bytes_ * 2, std::max(kMaxArenaChunkBytes, next_chunk_bytes_));
+    }
+
+    // Освобождает все блоки арены, кроме kept
+    void FreeChunksExcept(ChunkHeader* kept) noexcept {
+        ChunkHeader* chunk = current_;
+        while (chunk != nullptr) {
+            ChunkHeader* previous = chunk->previous;
+            if (chunk != kept) {
+                std::free(chunk);
+            }
+            chunk = previous;
+        }
+    }
+
+    ChunkHeader* current_ = nullptr;
+    char* top_ = nullptr;
+    char* end_ = nullptr;
+    size_t next_chunk_bytes_;
+};
+
+// Аллокатор для RawMemory и Vector, выделяющий память в арене. По умолчанию берёт арену текущего
+// потока, поэтому вектор с таким аллокатором нужно освобождать в том же потоке.
+// Поддерживает reallocate: верхний вектор арены растёт на месте, не перенося элементы.
+// Как и std::pmr::polymorphic_allocator, не переходит к другому вектору при присваивании,
+// чтобы долгоживущий вектор не оказался в памяти чужой арены
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = ArenaAllocator<U>;
+    };
+
+    ArenaAllocator() noexcept
+        : arena_(&Arena::ThreadLocal())
+    {
+    }
+
+    ArenaAllocator(Arena& arena) noexcept
+        : arena_(&arena)
+    {
+    }
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+        : arena_(&other.GetArena())
+    {
+    }
+
+    T* allocate(size_t n) {
+        if (n > SIZE_MAX / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(arena_->Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        arena_->Deallocate(p, n * sizeof(T));
+    }
+
+    // Меняет размер блока p с old_n на new_n элементов, сохраняя побайтово первые min(old_n, new_n)
+    T* reallocate(T* p, size_t old_n, size_t new_n) {
+        if (new_n > SIZE_MAX / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        if (arena_->ResizeInPlace(p, old_n * sizeof(T), new_n * sizeof(T))) {
+            return p;
+        }
+        T* result = allocate(new_n);
+        std::memcpy(static_cast<void*>(result), static_cast<const void*>(p), std::min(old_n, new_n) * sizeof(T));
+        deallocate(p, old_n);
+        return result;
+    }
+
+    Arena& GetArena() const noexcept {
+        return *arena_;
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept {
+        return arena_ == &other.GetArena();
+    }
+
+private:
+    Arena* arena_;
+};
\ No newline at end of file
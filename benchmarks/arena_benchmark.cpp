@@ -0,0 +1,88 @@
+// Обработка запросов, каждый из которых создаёт и уничтожает несколько временных векторов:
+// общий аллокатор против арены потока, которая очищается в конце каждого запроса.
+// Сборка: g++ -std=c++20 -O2 -DNDEBUG -pthread -I.. arena_benchmark.cpp -o arena_benchmark
+// Запуск: ./arena_benchmark [results.json]
+
+#include "../arena.h"
+#include "../vector.h"
+#include "benchmark_runner.h"
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t kRequests = 1 << 14;
+constexpr size_t kVectorsPerRequest = 16;
+constexpr size_t kElementsPerVector = 64;
+constexpr size_t kElements = kRequests * kVectorsPerRequest * kElementsPerVector;
+
+// Запрос строит несколько векторов, растущих с нуля, и сворачивает их в контрольную сумму
+template <typename Allocator>
+uint64_t HandleRequest(uint64_t request) {
+    uint64_t checksum = 0;
+    for (size_t i = 0; i < kVectorsPerRequest; ++i) {
+        Vector<uint64_t, Allocator> values;
+        for (size_t j = 0; j < kElementsPerVector; ++j) {
+            values.PushBack(request * j + i);
+        }
+        for (uint64_t value : values) {
+            checksum += value;
+        }
+    }
+    return checksum;
+}
+
+template <typename Handle>
+void RunHandlers(size_t threads, Handle handle) {
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (size_t thread = 0; thread < threads; ++thread) {
+        workers.emplace_back([thread, threads, &handle] {
+            uint64_t checksum = 0;
+            for (size_t request = thread; request < kRequests; request += threads) {
+                checksum += handle(request);
+            }
+            DoNotOptimize(checksum);
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    BenchmarkRunner runner;
+    for (size_t threads = 1; threads <= 32; threads *= 2) {
+        const std::string suffix = "/threads:" + std::to_string(threads);
+        runner.Run("GlobalAllocator/Request" + suffix, kElements, [] {
+            return 0;
+        }, [threads](int) {
+            RunHandlers(threads, [](uint64_t request) {
+                return HandleRequest<std::allocator<uint64_t>>(request);
+            });
+        });
+        runner.Run("ThreadLocalArena/Request" + suffix, kElements, [] {
+            return 0;
+        }, [threads](int) {
+            RunHandlers(threads, [](uint64_t request) {
+                const uint64_t checksum = HandleRequest<ArenaAllocator<uint64_t>>(request);
+                Arena::ThreadLocal().Reset();
+                return checksum;
+            });
+        });
+    }
+
+    if (argc > 1) {
+        std::ofstream out(argv[1]);
+        runner.WriteJson(out);
+    }
+    else {
+        runner.WriteJson(std::cout);
+    }
+}
\ No newline at end of file
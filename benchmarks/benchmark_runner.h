@@ -0,0 +1,63 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Минимальный самодостаточный аналог Google Benchmark: замеряет операции и печатает
+// результаты в его JSON-формате, чтобы их можно было сравнивать между релизами
+
+template <typename T>
+void DoNotOptimize(T&& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+struct BenchmarkResult {
+    std::string name;
+    size_t iterations;
+    double ns_per_element;
+};
+
+class BenchmarkRunner {
+public:
+    // Повторяет body, пока суммарное время не превысит порог; body обрабатывает elements элементов.
+    // setup выполняется перед каждым повтором и в замер не входит, но учитывается в ограничении
+    // общего времени, иначе быстрые операции с дорогой подготовкой выполнялись бы очень долго
+    template <typename Setup, typename Body>
+    void Run(const std::string& name, size_t elements, Setup setup, Body body) {
+        using Clock = std::chrono::steady_clock;
+        std::chrono::nanoseconds total{0};
+        size_t iterations = 0;
+        const auto deadline = Clock::now() + kMaxWallTime;
+        while ((total < kMinTime && Clock::now() < deadline) || iterations < kMinIterations) {
+            auto state = setup();
+            const auto start = Clock::now();
+            body(state);
+            total += Clock::now() - start;
+            DoNotOptimize(state);
+            ++iterations;
+        }
+        const double ns = static_cast<double>(total.count()) / static_cast<double>(iterations * elements);
+        std::cerr << name << ": " << ns << " ns/element" << std::endl;
+        results_.push_back({name, iterations, ns});
+    }
+
+    void WriteJson(std::ostream& out) const {
+        out << "{\n  \"context\": {\"library\": \"Vector\", \"time_unit\": \"ns/element\"},\n  \"benchmarks\": [\n";
+        for (size_t i = 0; i < results_.size(); ++i) {
+            const auto& result = results_[i];
+            out << "    {\"name\": \"" << result.name << "\", \"iterations\": " << result.iterations
+                << ", \"real_time\": " << result.ns_per_element << ", \"time_unit\": \"ns\"}"
+                << (i + 1 == results_.size() ? "\n" : ",\n");
+        }
+        out << "  ]\n}\n";
+    }
+
+private:
+    static constexpr std::chrono::milliseconds kMinTime{200};
+    static constexpr std::chrono::seconds kMaxWallTime{2};
+    static constexpr size_t kMinIterations = 5;
+
+    std::vector<BenchmarkResult> results_;
+};
\ No newline at end of file
@@ -0,0 +1,71 @@
+// Масштабирование одновременного добавления элементов из многих потоков:
+// ConcurrentVector против Vector, защищённого мьютексом.
+// Сборка: g++ -std=c++20 -O2 -DNDEBUG -pthread -I.. concurrent_vector_benchmark.cpp -o concurrent_vector_benchmark
+// Запуск: ./concurrent_vector_benchmark [results.json]
+
+#include "../concurrent_vector.h"
+#include "benchmark_runner.h"
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t kElements = 1 << 22;
+
+struct LockedVector {
+    std::mutex mutex;
+    Vector<uint64_t> data;
+};
+
+template <typename Push>
+void RunWriters(size_t threads, Push push) {
+    std::vector<std::thread> writers;
+    writers.reserve(threads);
+    for (size_t thread = 0; thread < threads; ++thread) {
+        writers.emplace_back([thread, threads, &push] {
+            for (size_t i = thread; i < kElements; i += threads) {
+                push(i);
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    BenchmarkRunner runner;
+    for (size_t threads = 1; threads <= 32; threads *= 2) {
+        const std::string suffix = "/threads:" + std::to_string(threads);
+        runner.Run("ConcurrentVector/PushBack" + suffix, kElements, [] {
+            return std::make_unique<ConcurrentVector<uint64_t>>();
+        }, [threads](auto& v) {
+            RunWriters(threads, [&v](uint64_t i) {
+                v->PushBack(i);
+            });
+        });
+        runner.Run("MutexVector/PushBack" + suffix, kElements, [] {
+            return std::make_unique<LockedVector>();
+        }, [threads](auto& v) {
+            RunWriters(threads, [&v](uint64_t i) {
+                std::lock_guard lock(v->mutex);
+                v->data.PushBack(i);
+            });
+        });
+    }
+
+    if (argc > 1) {
+        std::ofstream out(argv[1]);
+        runner.WriteJson(out);
+    }
+    else {
+        runner.WriteJson(std::cout);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,267 @@
+// Сравнение Vector и std::vector на основных операциях.
+// Сборка: g++ -std=c++20 -O2 -DNDEBUG -I.. vector_benchmark.cpp -o vector_benchmark
+// Запуск: ./vector_benchmark [results.json] — без аргумента JSON печатается в stdout.
+// Формат результатов совместим с выводом Google Benchmark (--benchmark_format=json)
+
+#include "../vector.h"
+#include "benchmark_runner.h"
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Типы элементов, на которых ведут себя по-разному разные ветки реализации
+using Trivial = uint64_t;
+
+using MoveOnly = std::unique_ptr<uint64_t>;
+
+// Перемещение может бросить исключение, поэтому при перевыделении элементы копируются
+struct ThrowingMove {
+    explicit ThrowingMove(uint64_t i)
+        : value(std::to_string(i) + "-padding-beyond-sso") {
+    }
+
+    ThrowingMove(const ThrowingMove&) = default;
+    ThrowingMove& operator=(const ThrowingMove&) = default;
+
+    ThrowingMove(ThrowingMove&& other) noexcept(false)
+        : value(std::move(other.value)) {
+    }
+
+    ThrowingMove& operator=(ThrowingMove&& other) noexcept(false) {
+        value = std::move(other.value);
+        return *this;
+    }
+
+    std::string value;
+};
+
+struct Large {
+    explicit Large(uint64_t i) {
+        payload.fill(i);
+    }
+
+    std::array<uint64_t, 32> payload;
+};
+
+template <typename T>
+T Make(uint64_t i) {
+    if constexpr (std::is_same_v<T, Trivial>) {
+        return i;
+    }
+    else if constexpr (std::is_same_v<T, MoveOnly>) {
+        return std::make_unique<uint64_t>(i);
+    }
+    else {
+        return T(i);
+    }
+}
+
+// Единый интерфейс к обоим контейнерам, чтобы тела бенчмарков не дублировались
+template <typename T>
+void PushBack(Vector<T>& v, T value) {
+    v.PushBack(std::move(value));
+}
+
+template <typename T>
+void PushBack(std::vector<T>& v, T value) {
+    v.push_back(std::move(value));
+}
+
+template <typename T>
+void EmplaceBack(Vector<T>& v, uint64_t i) {
+    v.EmplaceBack(Make<T>(i));
+}
+
+template <typename T>
+void EmplaceBack(std::vector<T>& v, uint64_t i) {
+    v.emplace_back(Make<T>(i));
+}
+
+template <typename T>
+void Reserve(Vector<T>& v, size_t n) {
+    v.Reserve(n);
+}
+
+template <typename T>
+void Reserve(std::vector<T>& v, size_t n) {
+    v.reserve(n);
+}
+
+template <typename T>
+void Resize(Vector<T>& v, size_t n) {
+    v.Resize(n);
+}
+
+template <typename T>
+void Resize(std::vector<T>& v, size_t n) {
+    v.resize(n);
+}
+
+template <typename T>
+void Resize(Vector<T>& v, size_t n, const T& value) {
+    v.Resize(n, value);
+}
+
+template <typename T>
+void Resize(std::vector<T>& v, size_t n, const T& value) {
+    v.resize(n, value);
+}
+
+template <typename T>
+void InsertAt(Vector<T>& v, size_t index, T value) {
+    v.Insert(v.begin() + index, std::move(value));
+}
+
+template <typename T>
+void InsertAt(std::vector<T>& v, size_t index, T value) {
+    v.insert(v.begin() + index, std::move(value));
+}
+
+template <typename T>
+void EraseAt(Vector<T>& v, size_t index) {
+    v.Erase(v.begin() + index);
+}
+
+template <typename T>
+void EraseAt(std::vector<T>& v, size_t index) {
+    v.erase(v.begin() + index);
+}
+
+template <typename T>
+size_t SizeOf(const Vector<T>& v) {
+    return v.Size();
+}
+
+template <typename T>
+size_t SizeOf(const std::vector<T>& v) {
+    return v.size();
+}
+
+template <typename Container>
+Container Filled(size_t n) {
+    using T = std::remove_cvref_t<decltype(*std::declval<Container&>().begin())>;
+    Container v;
+    Reserve(v, n);
+    for (size_t i = 0; i < n; ++i) {
+        PushBack(v, Make<T>(i));
+    }
+    return v;
+}
+
+constexpr size_t kSize = 1 << 14;
+constexpr size_t kShiftSize = 1 << 11;
+
+template <typename Container, typename T>
+void RunSuite(BenchmarkRunner& runner, const std::string& prefix) {
+    auto empty = [] {
+        return Container();
+    };
+    auto filled = [] {
+        return Filled<Container>(kSize);
+    };
+    auto filled_small = [] {
+        return Filled<Container>(kShiftSize);
+    };
+
+    runner.Run(prefix + "/PushBack", kSize, empty, [](Container& v) {
+        for (size_t i = 0; i < kSize; ++i) {
+            PushBack(v, Make<T>(i));
+        }
+    });
+    runner.Run(prefix + "/PushBackReserved", kSize, empty, [](Container& v) {
+        Reserve(v, kSize);
+        for (size_t i = 0; i < kSize; ++i) {
+            PushBack(v, Make<T>(i));
+        }
+    });
+    runner.Run(prefix + "/EmplaceBack", kSize, empty, [](Container& v) {
+        for (size_t i = 0; i < kSize; ++i) {
+            EmplaceBack(v, i);
+        }
+    });
+    runner.Run(prefix + "/EmplaceBackReserved", kSize, empty, [](Container& v) {
+        Reserve(v, kSize);
+        for (size_t i = 0; i < kSize; ++i) {
+            EmplaceBack(v, i);
+        }
+    });
+
+    for (const auto& [where, position] : {std::pair{"Front", 0}, std::pair{"Middle", 1}, std::pair{"Back", 2}}) {
+        runner.Run(prefix + "/Insert" + where, kShiftSize, filled_small, [position](Container& v) {
+            for (size_t i = 0; i < kShiftSize; ++i) {
+                InsertAt(v, SizeOf(v) * position / 2, Make<T>(i));
+            }
+        });
+        runner.Run(prefix + "/Erase" + where, kShiftSize, filled_small, [position](Container& v) {
+            for (size_t i = 0; i < kShiftSize; ++i) {
+                EraseAt(v, (SizeOf(v) - 1) * position / 2);
+            }
+        });
+    }
+
+    if constexpr (std::is_copy_constructible_v<T>) {
+        runner.Run(prefix + "/CopyConstruct", kSize, filled, [](Container& v) {
+            Container copy(v);
+            DoNotOptimize(copy);
+        });
+        runner.Run(prefix + "/CopyAssign", kSize, [] {
+            return std::pair{Filled<Container>(kSize), Filled<Container>(kSize / 2)};
+        }, [](auto& state) {
+            state.second = state.first;
+        });
+    }
+    runner.Run(prefix + "/MoveAssign", kSize, [] {
+        return std::pair{Filled<Container>(kSize), Filled<Container>(kSize / 2)};
+    }, [](auto& state) {
+        state.second = std::move(state.first);
+    });
+
+    if constexpr (std::is_default_constructible_v<T>) {
+        runner.Run(prefix + "/Resize", kSize, empty, [](Container& v) {
+            Resize(v, kSize);
+        });
+    }
+    // Типы без конструктора по умолчанию растут копиями образца
+    if constexpr (std::is_copy_constructible_v<T>) {
+        runner.Run(prefix + "/ResizeWithValue", kSize, empty, [](Container& v) {
+            Resize(v, kSize, Make<T>(kSize));
+        });
+    }
+
+    runner.Run(prefix + "/Iterate", kSize, filled, [](Container& v) {
+        for (auto& element : v) {
+            DoNotOptimize(element);
+        }
+    });
+}
+
+template <typename T>
+void RunBoth(BenchmarkRunner& runner, const std::string& type_name) {
+    RunSuite<Vector<T>, T>(runner, "Vector<" + type_name + ">");
+    RunSuite<std::vector<T>, T>(runner, "std::vector<" + type_name + ">");
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    BenchmarkRunner runner;
+    RunBoth<Trivial>(runner, "Trivial");
+    RunBoth<MoveOnly>(runner, "MoveOnly");
+    RunBoth<ThrowingMove>(runner, "ThrowingMove");
+    RunBoth<Large>(runner, "Large");
+
+    if (argc > 1) {
+        std::ofstream out(argv[1]);
+        runner.WriteJson(out);
+    }
+    else {
+        runner.WriteJson(std::cout);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,182 @@
+#pragma once
+#include "vector.h"
+
+#include <array>
+#include <atomic>
+#include <limits>
+#include <utility>
+
+// Вектор, в который несколько потоков одновременно добавляют элементы без блокировок.
+// Элементы хранятся в сегментах RawMemory, размеры которых растут степенями двойки: сегмент k
+// вмещает FirstSegmentSize << k элементов. Рост добавляет новый сегмент и никогда не перемещает
+// существующие элементы, поэтому ссылки и указатели на них остаются действительными.
+// Индекс для нового элемента выделяется атомарным fetch_add, после создания элемент
+// публикуется флагом, и читатели могут безопасно обращаться к нему через TryGet
+template <typename T, typename Allocator = std::allocator<T>, size_t FirstSegmentSize = 64>
+class ConcurrentVector {
+    static_assert(std::has_single_bit(FirstSegmentSize), "FirstSegmentSize must be a power of two");
+    using AllocTraits = std::allocator_traits<Allocator>;
+
+public:
+    using allocator_type = Allocator;
+
+    ConcurrentVector() = default;
+
+    explicit ConcurrentVector(const Allocator& alloc) noexcept
+        : alloc_(alloc)
+    {
+    }
+
+    ConcurrentVector(const ConcurrentVector&) = delete;
+    ConcurrentVector& operator=(const ConcurrentVector&) = delete;
+
+    ~ConcurrentVector() {
+        const size_t size = size_.load(std::memory_order_acquire);
+        for (size_t segment = 0; segment < kMaxSegments; ++segment) {
+            Segment* data = segments_[segment].load(std::memory_order_acquire);
+            if (data == nullptr) {
+                continue;
+            }
+            const size_t first = SegmentStart(segment);
+            const size_t count = size > first ? std::min(size - first, data->memory.Capacity()) : 0;
+            for (size_t offset = 0; offset < count; ++offset) {
+                if (data->published[offset].load(std::memory_order_acquire)) {
+                    AllocTraits::destroy(alloc_, data->memory.GetAddress() + offset);
+                }
+            }
+            delete data;
+        }
+    }
+
+    // Потокобезопасно добавляет элемент и возвращает ссылку на него.
+    // Если конструктор T бросит исключение, выделенный индекс останется пустым и неопубликованным
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        return *EmplaceAt(size_.fetch_add(1, std::memory_order_relaxed), std::forward<Args>(args)...);
+    }
+
+    // Потокобезопасно добавляет элемент и возвращает его индекс
+    size_t PushBack(const T& value) {
+        const size_t index = size_.fetch_add(1, std::memory_order_relaxed);
+        EmplaceAt(index, value);
+        return index;
+    }
+
+    size_t PushBack(T&& value) {
+        const size_t index = size_.fetch_add(1, std::memory_order_relaxed);
+        EmplaceAt(index, std::move(value));
+        return index;
+    }
+
+    // Заранее создаёт сегменты под capacity элементов, чтобы писатели не выделяли их в горячем цикле
+    void Reserve(size_t capacity) {
+        for (size_t segment = 0; capacity != 0 && SegmentStart(segment) < capacity; ++segment) {
+            GetOrCreateSegment(segment);
+        }
+    }
+
+    // Количество выделенных индексов. Элементы с последними индексами могут быть ещё не опубликованы
+    size_t Size() const noexcept {
+        return size_.load(std::memory_order_acquire);
+    }
+
+    // Возвращает указатель на элемент, если он уже создан и опубликован, иначе nullptr.
+    // Безопасно вызывать одновременно с добавлением элементов
+    const T* TryGet(size_t index) const noexcept {
+        const auto [segment, offset] = Locate(index);
+        if (segment >= kMaxSegments) {
+            return nullptr;
+        }
+        const Segment* data = segments_[segment].load(std::memory_order_acquire);
+        if (data == nullptr || !data->published[offset].load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return data->memory.GetAddress() + offset;
+    }
+
+    T* TryGet(size_t index) noexcept {
+        return const_cast<T*>(std::as_const(*this).TryGet(index));
+    }
+
+    // Доступ без проверки публикации: вызывающий должен знать, что элемент уже создан,
+    // например получив его индекс от PushBack или дождавшись завершения писателей
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<ConcurrentVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < Size());
+        const auto [segment, offset] = Locate(index);
+        return *(segments_[segment].load(std::memory_order_acquire)->memory.GetAddress() + offset);
+    }
+
+    // Вызывает f(index, element) для всех опубликованных элементов в порядке индексов
+    template <typename F>
+    void ForEachPublished(F f) const {
+        const size_t size = Size();
+        for (size_t index = 0; index < size; ++index) {
+            if (const T* element = TryGet(index)) {
+                f(index, *element);
+            }
+        }
+    }
+
+    Allocator GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+private:
+    struct Segment {
+        Segment(size_t capacity, const Allocator& alloc)
+            : memory(capacity, alloc)
+            , published(new std::atomic<bool>[capacity]())
+        {
+        }
+
+        RawMemory<T, Allocator> memory;
+        std::unique_ptr<std::atomic<bool>[]> published;
+    };
+
+    static constexpr size_t kMaxSegments = std::numeric_limits<size_t>::digits - std::countr_zero(FirstSegmentSize);
+
+    static size_t SegmentStart(size_t segment) noexcept {
+        return FirstSegmentSize * ((size_t{1} << segment) - 1);
+    }
+
+    // Возвращает номер сегмента и смещение в нём для элемента с индексом index
+    static std::pair<size_t, size_t> Locate(size_t index) noexcept {
+        const size_t segment = std::bit_width(index / FirstSegmentSize + 1) - 1;
+        return {segment, index - SegmentStart(segment)};
+    }
+
+    template <typename... Args>
+    T* EmplaceAt(size_t index, Args&&... args) {
+        const auto [segment, offset] = Locate(index);
+        assert(segment < kMaxSegments);
+        Segment& data = GetOrCreateSegment(segment);
+        // Писатели создают элементы через общий аллокатор одновременно, как и выделяют сегменты
+        T* element = data.memory.GetAddress() + offset;
+        AllocTraits::construct(alloc_, element, std::forward<Args>(args)...);
+        data.published[offset].store(true, std::memory_order_release);
+        return element;
+    }
+
+    Segment& GetOrCreateSegment(size_t segment) {
+        Segment* data = segments_[segment].load(std::memory_order_acquire);
+        if (data != nullptr) {
+            return *data;
+        }
+        auto fresh = std::make_unique<Segment>(FirstSegmentSize << segment, alloc_);
+        if (segments_[segment].compare_exchange_strong(data, fresh.get(), std::memory_order_acq_rel,
+                                                       std::memory_order_acquire)) {
+            return *fresh.release();
+        }
+        // Сегмент успел создать другой поток, а наш экземпляр освобождается
+        return *data;
+    }
+
+    [[no_unique_address]] Allocator alloc_;
+    std::array<std::atomic<Segment*>, kMaxSegments> segments_{};
+    // Счётчик в отдельной кэш-линии, чтобы его изменения не вытесняли из кэшей таблицу сегментов
+    alignas(64) std::atomic<size_t> size_{0};
+};
\ No newline at end of file
@@ -0,0 +1,108 @@
+#pragma once
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+// Итератор произвольного доступа по контейнеру с operator[]: хранит указатель на контейнер
+// и индекс элемента, а не адрес, поэтому переживает переход между блоками и перевыделение.
+// Container должен объявлять value_type, reference и const_reference; разыменование
+// возвращает (*owner)[index]. Если reference — не настоящая ссылка (например, кортеж ссылок
+// на поля записи), operator-> не предоставляется
+template <typename Container, bool IsConst>
+class IndexIterator {
+    using Owner = std::conditional_t<IsConst, const Container, Container>;
+
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = typename Container::value_type;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::conditional_t<IsConst, typename Container::const_reference, typename Container::reference>;
+    using pointer = std::conditional_t<std::is_reference_v<reference>, std::add_pointer_t<reference>, void>;
+
+    IndexIterator() = default;
+
+    IndexIterator(Owner* owner, size_t index) noexcept
+        : owner_(owner)
+        , index_(index)
+    {
+    }
+
+    // Неконстантный итератор неявно приводится к константному
+    operator IndexIterator<Container, true>() const noexcept {
+        return IndexIterator<Container, true>(owner_, index_);
+    }
+
+    reference operator*() const noexcept {
+        return (*owner_)[index_];
+    }
+
+    pointer operator->() const noexcept requires std::is_reference_v<reference> {
+        return std::addressof(**this);
+    }
+
+    reference operator[](difference_type offset) const noexcept {
+        return *(*this + offset);
+    }
+
+    IndexIterator& operator++() noexcept {
+        ++index_;
+        return *this;
+    }
+
+    IndexIterator operator++(int) noexcept {
+        IndexIterator copy = *this;
+        ++index_;
+        return copy;
+    }
+
+    IndexIterator& operator--() noexcept {
+        --index_;
+        return *this;
+    }
+
+    IndexIterator operator--(int) noexcept {
+        IndexIterator copy = *this;
+        --index_;
+        return copy;
+    }
+
+    IndexIterator& operator+=(difference_type offset) noexcept {
+        index_ += offset;
+        return *this;
+    }
+
+    IndexIterator& operator-=(difference_type offset) noexcept {
+        index_ -= offset;
+        return *this;
+    }
+
+    friend IndexIterator operator+(IndexIterator it, difference_type offset) noexcept {
+        return it += offset;
+    }
+
+    friend IndexIterator operator+(difference_type offset, IndexIterator it) noexcept {
+        return it += offset;
+    }
+
+    friend IndexIterator operator-(IndexIterator it, difference_type offset) noexcept {
+        return it -= offset;
+    }
+
+    friend difference_type operator-(const IndexIterator& lhs, const IndexIterator& rhs) noexcept {
+        return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+    }
+
+    friend bool operator==(const IndexIterator& lhs, const IndexIterator& rhs) noexcept {
+        return lhs.index_ == rhs.index_;
+    }
+
+    friend auto operator<=>(const IndexIterator& lhs, const IndexIterator& rhs) noexcept {
+        return lhs.index_ <=> rhs.index_;
+    }
+
+private:
+    Owner* owner_ = nullptr;
+    size_t index_ = 0;
+};
\ No newline at end of file
@@ -0,0 +1,325 @@
+#pragma once
+#include "vector.h"
+
+#include <cerrno>
+#include <string>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Заголовок файла MappedVector. Хранит всё, что нужно, чтобы открыть файл без разбора:
+// элементы начинаются сразу за ним, со смещения kMappedVectorDataOffset
+struct MappedVectorHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t element_size;
+    uint32_t element_alignment;
+    uint32_t reserved;
+    uint64_t size;
+    uint64_t capacity;
+};
+
+inline constexpr uint64_t kMappedVectorMagic = 0x524F544345564D4D;  // "MMVECTOR"
+inline constexpr uint32_t kMappedVectorVersion = 1;
+// Смещение данных выбрано с запасом на рост заголовка и выравнивает элементы на кэш-линию
+inline constexpr size_t kMappedVectorDataOffset = 64;
+
+enum class MappedVectorMode {
+    // Только чтение: файл отображается без копирования, страницы подгружаются при первом обращении
+    kReadOnly,
+    // Чтение и дописывание; отсутствующий файл создаётся пустым
+    kReadWrite,
+};
+
+// Вектор тривиально копируемых элементов, хранящий их в отображённом в память файле.
+// Открытие готового файла не читает и не разбирает данные: элементы доступны сразу,
+// а ядро подгружает страницы по мере обращения к ним. При дописывании файл растёт через
+// ftruncate и отображается заново, поэтому указатели на элементы действительны только
+// до следующего роста. Изменения попадают на диск при вытеснении страниц или явном Flush.
+// Ошибки системных вызовов, несовместимый заголовок и попытки изменить вектор, открытый только
+// для чтения, сообщаются через std::system_error
+template <typename T>
+class MappedVector {
+    static_assert(std::is_trivially_copyable_v<T>, "MappedVector stores elements as raw bytes");
+    static_assert(alignof(T) <= kMappedVectorDataOffset, "MappedVector cannot align elements this strictly");
+
+public:
+    MappedVector(const std::string& path, MappedVectorMode mode)
+        : writable_(mode == MappedVectorMode::kReadWrite)
+    {
+        fd_ = open(path.c_str(), writable_ ? O_RDWR | O_CREAT | O_CLOEXEC : O_RDONLY | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            throw std::system_error(errno, std::generic_category(), "MappedVector: cannot open " + path);
+        }
+        try {
+            struct stat st;
+            if (fstat(fd_, &st) != 0) {
+                ThrowErrno("fstat");
+            }
+            if (st.st_size == 0 && writable_) {
+                InitializeFile();
+            }
+            else {
+                Map(static_cast<size_t>(st.st_size));
+                Validate(static_cast<size_t>(st.st_size));
+            }
+        }
+        catch (...) {
+            Close();
+            throw;
+        }
+    }
+
+    MappedVector(const MappedVector&) = delete;
+    MappedVector& operator=(const MappedVector&) = delete;
+
+    MappedVector(MappedVector&& other) noexcept
+        : fd_(std::exchange(other.fd_, -1))
+        , mapping_(std::exchange(other.mapping_, nullptr))
+        , mapped_bytes_(std::exchange(other.mapped_bytes_, 0))
+        , writable_(other.writable_)
+    {
+    }
+
+    MappedVector& operator=(MappedVector&& rhs) noexcept {
+        if (this != &rhs) {
+            Close();
+            fd_ = std::exchange(rhs.fd_, -1);
+            mapping_ = std::exchange(rhs.mapping_, nullptr);
+            mapped_bytes_ = std::exchange(rhs.mapped_bytes_, 0);
+            writable_ = rhs.writable_;
+        }
+        return *this;
+    }
+
+    ~MappedVector() {
+        Close();
+    }
+
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    // Неконстантный доступ разрешён и в режиме только для чтения, но записывать через него
+    // тогда нельзя: страницы отображены без права записи
+    iterator begin() noexcept {
+        return Data();
+    }
+
+    iterator end() noexcept {
+        return begin() + Size();
+    }
+
+    const_iterator begin() const noexcept {
+        return cbegin();
+    }
+
+    const_iterator end() const noexcept {
+        return cend();
+    }
+
+    const_iterator cbegin() const noexcept {
+        return const_cast<MappedVector&>(*this).Data();
+    }
+
+    const_iterator cend() const noexcept {
+        return cbegin() + Size();
+    }
+
+    // Увеличивает файл так, чтобы он вмещал new_capacity элементов
+    void Reserve(size_t new_capacity) {
+        RequireWritable("Reserve");
+        if (new_capacity <= Capacity()) {
+            return;
+        }
+        if (new_capacity > (SIZE_MAX - kMappedVectorDataOffset) / sizeof(T)) {
+            throw std::system_error(std::make_error_code(std::errc::file_too_large), "MappedVector: capacity overflow");
+        }
+        const size_t new_bytes = kMappedVectorDataOffset + new_capacity * sizeof(T);
+        if (ftruncate(fd_, static_cast<off_t>(new_bytes)) != 0) {
+            ThrowErrno("ftruncate");
+        }
+        Remap(new_bytes);
+        Header().capacity = new_capacity;
+    }
+
+    // Новые элементы инициализируются значением: дописанная ftruncate часть файла уже заполнена нулями
+    void Resize(size_t new_size) {
+        RequireWritable("Resize");
+        if (new_size > Capacity()) {
+            Reserve(new_size);
+        }
+        if (new_size > Size()) {
+            std::uninitialized_value_construct_n(Data() + Size(), new_size - Size());
+        }
+        Header().size = new_size;
+    }
+
+    void PushBack(const T& value) {
+        (void)EmplaceBack(value);
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        RequireWritable("EmplaceBack");
+        // Элемент создаётся до роста файла: аргументы могут ссылаться на отображённые элементы
+        const T value(std::forward<Args>(args)...);
+        const size_t size = Size();
+        if (size == Capacity()) {
+            Reserve(DoublingGrowth::NextCapacity<T>(Capacity(), size + 1));
+        }
+        T* element = new (Data() + size) T(value);
+        // Размер увеличивается после записи элемента, чтобы файл не описывал непрочитанный мусор
+        Header().size = size + 1;
+        return *element;
+    }
+
+    void PopBack() {
+        RequireWritable("PopBack");
+        assert(Size() != 0);
+        --Header().size;
+    }
+
+    void Clear() {
+        RequireWritable("Clear");
+        Header().size = 0;
+    }
+
+    // Синхронно записывает изменённые страницы отображения на диск
+    void Flush() {
+        if (writable_ && mapping_ != nullptr && msync(mapping_, mapped_bytes_, MS_SYNC) != 0) {
+            ThrowErrno("msync");
+        }
+    }
+
+    // Перемещённый вектор не владеет файлом и выглядит пустым
+    size_t Size() const noexcept {
+        return mapping_ == nullptr ? 0 : static_cast<size_t>(Header().size);
+    }
+
+    size_t Capacity() const noexcept {
+        return mapping_ == nullptr ? 0 : static_cast<size_t>(Header().capacity);
+    }
+
+    bool IsWritable() const noexcept {
+        return writable_;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        assert(index < Size());
+        return cbegin()[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < Size());
+        return Data()[index];
+    }
+
+private:
+    MappedVectorHeader& Header() noexcept {
+        return *static_cast<MappedVectorHeader*>(mapping_);
+    }
+
+    const MappedVectorHeader& Header() const noexcept {
+        return *static_cast<const MappedVectorHeader*>(mapping_);
+    }
+
+    T* Data() noexcept {
+        if (mapping_ == nullptr) {
+            return nullptr;
+        }
+        return reinterpret_cast<T*>(static_cast<char*>(mapping_) + kMappedVectorDataOffset);
+    }
+
+    [[noreturn]] static void ThrowErrno(const char* call) {
+        throw std::system_error(errno, std::generic_category(), std::string("MappedVector: ") + call);
+    }
+
+    // Отображение открытого только для чтения файла защищено PROT_READ, и запись в него
+    // завершила бы процесс по SIGSEGV, поэтому изменяющие операции проверяют режим и в NDEBUG
+    void RequireWritable(const char* operation) const {
+        if (!writable_) {
+            throw std::system_error(EROFS, std::generic_category(),
+                                    std::string("MappedVector: ") + operation + " on a read-only vector");
+        }
+    }
+
+    static MappedVectorHeader ExpectedHeader() noexcept {
+        MappedVectorHeader header{};
+        header.magic = kMappedVectorMagic;
+        header.version = kMappedVectorVersion;
+        header.element_size = sizeof(T);
+        header.element_alignment = alignof(T);
+        return header;
+    }
+
+    void InitializeFile() {
+        if (ftruncate(fd_, static_cast<off_t>(kMappedVectorDataOffset)) != 0) {
+            ThrowErrno("ftruncate");
+        }
+        Map(kMappedVectorDataOffset);
+        Header() = ExpectedHeader();
+    }
+
+    void Validate(size_t file_bytes) const {
+        const MappedVectorHeader expected = ExpectedHeader();
+        const MappedVectorHeader& header = Header();
+        const bool compatible = header.magic == expected.magic && header.version == expected.version
+                                && header.element_size == expected.element_size
+                                && header.element_alignment == expected.element_alignment
+                                && header.size <= header.capacity
+                                && header.capacity <= (file_bytes - kMappedVectorDataOffset) / sizeof(T);
+        if (!compatible) {
+            throw std::system_error(std::make_error_code(std::errc::invalid_argument),
+                                    "MappedVector: incompatible or corrupted file header");
+        }
+    }
+
+    void Map(size_t bytes) {
+        if (bytes < kMappedVectorDataOffset) {
+            throw std::system_error(std::make_error_code(std::errc::invalid_argument), "MappedVector: file is too short");
+        }
+        const int protection = writable_ ? PROT_READ | PROT_WRITE : PROT_READ;
+        void* mapping = mmap(nullptr, bytes, protection, MAP_SHARED, fd_, 0);
+        if (mapping == MAP_FAILED) {
+            ThrowErrno("mmap");
+        }
+        mapping_ = mapping;
+        mapped_bytes_ = bytes;
+    }
+
+    // Linux переносит отображение целиком через mremap, на остальных системах оно создаётся заново
+    void Remap(size_t bytes) {
+#ifdef __linux__
+        void* mapping = mremap(mapping_, mapped_bytes_, bytes, MREMAP_MAYMOVE);
+        if (mapping == MAP_FAILED) {
+            ThrowErrno("mremap");
+        }
+        mapping_ = mapping;
+        mapped_bytes_ = bytes;
+#else
+        void* old_mapping = mapping_;
+        const size_t old_bytes = mapped_bytes_;
+        Map(bytes);
+        munmap(old_mapping, old_bytes);
+#endif
+    }
+
+    void Close() noexcept {
+        if (mapping_ != nullptr) {
+            munmap(mapping_, mapped_bytes_);
+            mapping_ = nullptr;
+            mapped_bytes_ = 0;
+        }
+        if (fd_ >= 0) {
+            close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    int fd_ = -1;
+    void* mapping_ = nullptr;
+    size_t mapped_bytes_ = 0;
+    bool writable_ = false;
+};
\ No newline at end of file
@@ -0,0 +1,329 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+
+// Пул буферов для векторов, которые раз за разом растут через одни и те же вместимости и
+// освобождаются. Блоки округляются до степени двойки от kMinPoolBlockBytes до kMaxPoolBlockBytes,
+// а освобождённые блоки каждого размерного класса копятся в списках текущего потока, пока их общий
+// объём не превысит бюджет потока. Излишки и блоки завершившихся потоков уходят в общее хранилище
+// под мьютексом, из которого потоки пополняют опустевшие списки. Так блок, освобождённый не тем
+// потоком, что его выделил, возвращается к выделяющему потоку. Блоки крупнее kMaxPoolBlockBytes
+// выделяются напрямую через operator new
+
+inline constexpr size_t kMinPoolBlockBytes = 16;
+inline constexpr size_t kMaxPoolBlockBytes = size_t{1} << 20;
+
+class PoolSettings {
+public:
+    // Сколько байт освобождённых блоков может держать у себя каждый поток
+    static void SetThreadCacheBytes(size_t bytes) noexcept {
+        thread_cache_bytes_.store(bytes, std::memory_order_relaxed);
+    }
+
+    // Сколько байт может держать общее хранилище; сверх этого блоки возвращаются operator delete
+    static void SetDepotBytes(size_t bytes) noexcept {
+        depot_bytes_.store(bytes, std::memory_order_relaxed);
+    }
+
+    static size_t ThreadCacheBytes() noexcept {
+        return thread_cache_bytes_.load(std::memory_order_relaxed);
+    }
+
+    static size_t DepotBytes() noexcept {
+        return depot_bytes_.load(std::memory_order_relaxed);
+    }
+
+private:
+    static inline std::atomic<size_t> thread_cache_bytes_{size_t{2} << 20};
+    static inline std::atomic<size_t> depot_bytes_{size_t{32} << 20};
+};
+
+class BlockPool {
+public:
+    // Размер блока, который реально получит запрос на bytes байт
+    static size_t BlockBytes(size_t bytes) noexcept {
+        return bytes > kMaxPoolBlockBytes ? bytes : ClassBytes(ClassOf(bytes));
+    }
+
+    static void* Allocate(size_t bytes) {
+        if (bytes > kMaxPoolBlockBytes) {
+            return ::operator new(bytes);
+        }
+        const size_t size_class = ClassOf(bytes);
+        if (ThreadCache* cache = ThreadCache::Get()) {
+            return cache->Allocate(size_class);
+        }
+        if (FreeBlock* block = Depot::Instance().Take(size_class, 1).first) {
+            return block;
+        }
+        return ::operator new(ClassBytes(size_class));
+    }
+
+    // bytes должен совпадать с размером, переданным в Allocate
+    static void Deallocate(void* p, size_t bytes) noexcept {
+        if (bytes > kMaxPoolBlockBytes) {
+            ::operator delete(p);
+            return;
+        }
+        const size_t size_class = ClassOf(bytes);
+        auto* block = static_cast<FreeBlock*>(p);
+        block->next = nullptr;
+        if (ThreadCache* cache = ThreadCache::Get()) {
+            cache->Deallocate(size_class, block);
+        }
+        else {
+            Depot::Instance().Put(size_class, block, block, 1);
+        }
+    }
+
+    // Отдаёт все блоки текущего потока в общее хранилище, например перед долгим простоем потока
+    static void TrimThreadCache() noexcept {
+        if (ThreadCache* cache = ThreadCache::Get()) {
+            cache->Drain();
+        }
+    }
+
+private:
+    static constexpr size_t kClassCount = std::countr_zero(kMaxPoolBlockBytes / kMinPoolBlockBytes) + 1;
+    // Между потоком и хранилищем блоки переходят пачками примерно по столько байт
+    static constexpr size_t kTransferBytes = size_t{64} << 10;
+    static constexpr size_t kMaxTransferBlocks = 64;
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    static size_t ClassOf(size_t bytes) noexcept {
+        return bytes <= kMinPoolBlockBytes ? 0 : std::bit_width(bytes - 1) - std::countr_zero(kMinPoolBlockBytes);
+    }
+
+    static constexpr size_t ClassBytes(size_t size_class) noexcept {
+        return kMinPoolBlockBytes << size_class;
+    }
+
+    static constexpr size_t TransferBlocks(size_t size_class) noexcept {
+        return std::clamp<size_t>(kTransferBytes / ClassBytes(size_class), 1, kMaxTransferBlocks);
+    }
+
+    // Общее хранилище: по односвязному списку на класс под одним мьютексом
+    class Depot {
+    public:
+        // Не уничтожается при завершении программы: потоки могут возвращать блоки и позже
+        static Depot& Instance() {
+            static Depot& depot = *new Depot;
+            return depot;
+        }
+
+        // Принимает цепочку из count блоков от first до last. Не поместившиеся в бюджет блоки освобождаются
+        void Put(size_t size_class, FreeBlock* first, FreeBlock* last, size_t count) noexcept {
+            const size_t class_bytes = ClassBytes(size_class);
+            const size_t budget = PoolSettings::DepotBytes();
+            {
+                std::lock_guard lock(mutex_);
+                const size_t fits = std::min(count, (budget - std::min(budget, bytes_)) / class_bytes);
+                if (fits == count) {
+                    last->next = lists_[size_class];
+                    lists_[size_class] = first;
+                    bytes_ += count * class_bytes;
+                    return;
+                }
+                for (size_t i = 0; i < fits; ++i) {
+                    FreeBlock* next = first->next;
+                    first->next = lists_[size_class];
+                    lists_[size_class] = first;
+                    first = next;
+                }
+                bytes_ += fits * class_bytes;
+            }
+            while (first != nullptr) {
+                FreeBlock* next = first->next;
+                ::operator delete(static_cast<void*>(first));
+                first = next;
+            }
+        }
+
+        // Забирает до count блоков класса; возвращает цепочку и число блоков в ней
+        std::pair<FreeBlock*, size_t> Take(size_t size_class, size_t count) noexcept {
+            std::lock_guard lock(mutex_);
+            FreeBlock* first = lists_[size_class];
+            if (first == nullptr) {
+                return {nullptr, 0};
+            }
+            FreeBlock* last = first;
+            size_t taken = 1;
+            while (taken < count && last->next != nullptr) {
+                last = last->next;
+                ++taken;
+            }
+            lists_[size_class] = last->next;
+            last->next = nullptr;
+            bytes_ -= taken * ClassBytes(size_class);
+            return {first, taken};
+        }
+
+    private:
+        std::mutex mutex_;
+        FreeBlock* lists_[kClassCount] = {};
+        size_t bytes_ = 0;
+    };
+
+    // Списки свободных блоков одного потока; обращения к ним не требуют синхронизации
+    class ThreadCache {
+    public:
+        // Возвращает nullptr, если кэш потока уже уничтожен (из деструкторов других thread_local объектов)
+        static ThreadCache* Get() noexcept {
+            if (destroyed_) {
+                return nullptr;
+            }
+            thread_local ThreadCache cache;
+            return &cache;
+        }
+
+        ~ThreadCache() {
+            Drain();
+            destroyed_ = true;
+        }
+
+        void* Allocate(size_t size_class) {
+            if (lists_[size_class] == nullptr) {
+                auto [first, count] = Depot::Instance().Take(size_class, TransferBlocks(size_class));
+                if (first == nullptr) {
+                    return ::operator new(ClassBytes(size_class));
+                }
+                lists_[size_class] = first;
+                counts_[size_class] = count;
+                bytes_ += count * ClassBytes(size_class);
+            }
+            FreeBlock* block = lists_[size_class];
+            lists_[size_class] = block->next;
+            --counts_[size_class];
+            bytes_ -= ClassBytes(size_class);
+            return block;
+        }
+
+        void Deallocate(size_t size_class, FreeBlock* block) noexcept {
+            block->next = lists_[size_class];
+            lists_[size_class] = block;
+            ++counts_[size_class];
+            bytes_ += ClassBytes(size_class);
+            if (bytes_ > PoolSettings::ThreadCacheBytes()) {
+                Release(size_class, std::min(counts_[size_class], TransferBlocks(size_class)));
+            }
+        }
+
+        void Drain() noexcept {
+            for (size_t size_class = 0; size_class < kClassCount; ++size_class) {
+                Release(size_class, counts_[size_class]);
+            }
+        }
+
+    private:
+        // Отдаёт count блоков класса из начала списка в общее хранилище
+        void Release(size_t size_class, size_t count) noexcept {
+            if (count == 0) {
+                return;
+            }
+            FreeBlock* first = lists_[size_class];
+            FreeBlock* last = first;
+            for (size_t i = 1; i < count; ++i) {
+                last = last->next;
+            }
+            lists_[size_class] = last->next;
+            last->next = nullptr;
+            counts_[size_class] -= count;
+            bytes_ -= count * ClassBytes(size_class);
+            Depot::Instance().Put(size_class, first, last, count);
+        }
+
+        static inline thread_local bool destroyed_ = false;
+
+        FreeBlock* lists_[kClassCount] = {};
+        size_t counts_[kClassCount] = {};
+        size_t bytes_ = 0;
+    };
+};
+
+// Аллокатор для RawMemory и Vector, берущий буферы из BlockPool. Вектор, растущий удвоением,
+// получает блоки ровно своих вместимостей, а освобождённые при росте буферы достаются следующему
+// вектору того же потока без обращения к malloc. Типы с выравниванием сильнее, чем гарантирует
+// operator new, пул не обслуживает, для них память выделяет std::allocator
+template <typename T>
+class PoolAllocator {
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    template <typename U>
+    struct rebind {
+        using other = PoolAllocator<U>;
+    };
+
+    PoolAllocator() = default;
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        if constexpr (!kPooled) {
+            return std::allocator<T>().allocate(n);
+        }
+        else {
+            if (n > SIZE_MAX / sizeof(T)) {
+                throw std::bad_alloc();
+            }
+            return static_cast<T*>(BlockPool::Allocate(n * sizeof(T)));
+        }
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        if constexpr (!kPooled) {
+            std::allocator<T>().deallocate(p, n);
+        }
+        else {
+            BlockPool::Deallocate(p, n * sizeof(T));
+        }
+    }
+
+    // Блок уже занимает целый размерный класс, поэтому рост в его пределах не требует нового блока
+    T* reallocate(T* p, size_t old_n, size_t new_n) {
+        if (new_n > SIZE_MAX / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        if constexpr (kPooled) {
+            if (BlockPool::BlockBytes(old_n * sizeof(T)) == BlockPool::BlockBytes(new_n * sizeof(T))) {
+                return p;
+            }
+        }
+        T* result = allocate(new_n);
+        std::memcpy(static_cast<void*>(result), static_cast<const void*>(p), std::min(old_n, new_n) * sizeof(T));
+        deallocate(p, old_n);
+        return result;
+    }
+
+    // Сколько элементов помещается в блок, который получит запрос на n элементов.
+    // С этим SizeClassGrowth растит вектор сразу до границы размерного класса
+    size_t good_size(size_t n) const noexcept {
+        if constexpr (kPooled) {
+            if (n <= kMaxPoolBlockBytes / sizeof(T)) {
+                return BlockPool::BlockBytes(n * sizeof(T)) / sizeof(T);
+            }
+        }
+        return n;
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>&) const noexcept {
+        return true;
+    }
+
+private:
+    static constexpr bool kPooled = alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+};
\ No newline at end of file
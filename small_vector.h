@@ -0,0 +1,294 @@
+#pragma once
+#include "vector.h"
+
+// Вектор, хранящий до N элементов прямо внутри объекта. Пока элементы помещаются во встроенный
+// буфер, динамическая память не выделяется; при переполнении они переносятся в RawMemory
+template <typename T, size_t N, typename Allocator = std::allocator<T>>
+class SmallVector {
+    static_assert(N > 0, "SmallVector requires a non-empty inline buffer");
+    using AllocTraits = std::allocator_traits<Allocator>;
+
+public:
+    using allocator_type = Allocator;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    SmallVector() = default;
+
+    explicit SmallVector(const Allocator& alloc) noexcept
+        : heap_(alloc)
+    {
+    }
+
+    explicit SmallVector(size_t size, const Allocator& alloc = Allocator())
+        : heap_(alloc)
+    {
+        Reserve(size);
+        ValueConstructUninitializedN(heap_.GetAllocator(), begin(), size);
+        size_ = size;
+    }
+
+    SmallVector(const SmallVector& other)
+        : SmallVector(other, AllocTraits::select_on_container_copy_construction(other.GetAllocator()))
+    {
+    }
+
+    SmallVector(const SmallVector& other, const Allocator& alloc)
+        : heap_(alloc)
+    {
+        Reserve(other.size_);
+        CopyUninitializedN(heap_.GetAllocator(), other.begin(), other.size_, begin());
+        size_ = other.size_;
+    }
+
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : heap_(other.GetAllocator())
+    {
+        MoveFrom(other);
+    }
+
+    ~SmallVector() {
+        DestroyN(heap_.GetAllocator(), begin(), size_);
+    }
+
+    SmallVector& operator=(const SmallVector& rhs) {
+        if (this != &rhs) {
+            if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+                if (GetAllocator() != rhs.GetAllocator()) {
+                    // Копия строится аллокатором, который останется у вектора, а свой буфер
+                    // освобождается своим аллокатором до того, как тот будет заменён
+                    SmallVector rhs_copy(rhs, rhs.GetAllocator());
+                    DestroyN(heap_.GetAllocator(), begin(), size_);
+                    size_ = 0;
+                    heap_ = RawMemory<T, Allocator>(rhs.GetAllocator());
+                    MoveFrom(rhs_copy);
+                    return *this;
+                }
+            }
+            if (rhs.size_ > Capacity()) {
+                // Копия не помещается во встроенный буфер, поэтому лежит в динамическом буфере
+                // с нашим аллокатором и забирается целиком. Swap здесь не подходит: если вектор
+                // ещё во встроенном буфере, он переносит элементы поштучно
+                SmallVector rhs_copy(rhs, GetAllocator());
+                DestroyN(heap_.GetAllocator(), begin(), size_);
+                size_ = 0;
+                MoveFrom(rhs_copy);
+            }
+            else {
+                size_t copy_size = std::min(rhs.size_, size_);
+                std::copy_n(rhs.begin(), copy_size, begin());
+                if (rhs.size_ < size_) {
+                    DestroyN(heap_.GetAllocator(), begin() + rhs.size_, size_ - rhs.size_);
+                }
+                else {
+                    CopyUninitializedN(heap_.GetAllocator(), rhs.begin() + size_, rhs.size_ - size_, end());
+                }
+                size_ = rhs.size_;
+            }
+        }
+        return *this;
+    }
+
+    // Без propagate_on_container_move_assignment динамический буфер rhs с другим аллокатором
+    // забрать нельзя, и его элементы переносятся в память, выделенную своим аллокатором
+    SmallVector& operator=(SmallVector&& rhs) noexcept(std::is_nothrow_move_constructible_v<T>
+                                                       && (AllocTraits::propagate_on_container_move_assignment::value
+                                                           || AllocTraits::is_always_equal::value)) {
+        if (this != &rhs) {
+            DestroyN(heap_.GetAllocator(), begin(), size_);
+            size_ = 0;
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+                // Свой буфер освобождается своим аллокатором, после чего аллокатор rhs переходит к нам
+                heap_ = RawMemory<T, Allocator>(rhs.GetAllocator());
+            }
+            MoveFrom(rhs);
+        }
+        return *this;
+    }
+
+    iterator begin() noexcept {
+        return Data();
+    }
+
+    iterator end() noexcept {
+        return Data() + size_;
+    }
+
+    const_iterator begin() const noexcept {
+        return cbegin();
+    }
+
+    const_iterator end() const noexcept {
+        return cend();
+    }
+
+    const_iterator cbegin() const noexcept {
+        return const_cast<SmallVector&>(*this).Data();
+    }
+
+    const_iterator cend() const noexcept {
+        return cbegin() + size_;
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity <= Capacity()) {
+            return;
+        }
+        RawMemory<T, Allocator> new_data(new_capacity, heap_.GetAllocator());
+        RelocateUninitializedN(heap_.GetAllocator(), begin(), size_, new_data.GetAddress());
+        heap_.Swap(new_data);
+    }
+
+    void Resize(size_t new_size) {
+        if (new_size < size_) {
+            DestroyN(heap_.GetAllocator(), begin() + new_size, size_ - new_size);
+        }
+        else if (new_size > size_) {
+            Reserve(new_size);
+            ValueConstructUninitializedN(heap_.GetAllocator(), end(), new_size - size_);
+        }
+        size_ = new_size;
+    }
+
+    void PushBack(const T& value) {
+        (void)EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        (void)EmplaceBack(std::move(value));
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        if (size_ == Capacity()) {
+            RawMemory<T, Allocator> new_data(Capacity() * 2, heap_.GetAllocator());
+            AllocTraits::construct(heap_.GetAllocator(), new_data.GetAddress() + size_, std::forward<Args>(args)...);
+            try {
+                RelocateUninitializedN(heap_.GetAllocator(), begin(), size_, new_data.GetAddress());
+            }
+            catch (...) {
+                AllocTraits::destroy(heap_.GetAllocator(), new_data.GetAddress() + size_);
+                throw;
+            }
+            heap_.Swap(new_data);
+        }
+        else {
+            AllocTraits::construct(heap_.GetAllocator(), end(), std::forward<Args>(args)...);
+        }
+        ++size_;
+        return *(end() - 1);
+    }
+
+    template <typename... Args>
+    iterator Emplace(const_iterator pos, Args&&... args) {
+        assert(begin() <= pos && pos <= end());
+        size_t index = pos - begin();
+        if (pos == end()) {
+            return &EmplaceBack(std::forward<Args>(args)...);
+        }
+        if (size_ == Capacity()) {
+            RawMemory<T, Allocator> new_data(Capacity() * 2, heap_.GetAllocator());
+            AllocTraits::construct(heap_.GetAllocator(), new_data.GetAddress() + index, std::forward<Args>(args)...);
+            RelocateAroundGap(heap_.GetAllocator(), begin(), size_, index, 1, new_data.GetAddress());
+            heap_.Swap(new_data);
+        }
+        else {
+            EmplaceShiftingTail(heap_.GetAllocator(), begin(), size_, index, std::forward<Args>(args)...);
+        }
+        ++size_;
+        return begin() + index;
+    }
+
+    iterator Erase(const_iterator pos) noexcept(kRelocatesBitwise || std::is_nothrow_move_assignable_v<T>) {
+        assert(begin() <= pos && pos < end());
+        size_t index = pos - begin();
+        if constexpr (kRelocatesBitwise) {
+            AllocTraits::destroy(heap_.GetAllocator(), begin() + index);
+            std::memmove(static_cast<void*>(begin() + index), static_cast<const void*>(begin() + index + 1),
+                         (size_ - index - 1) * sizeof(T));
+            --size_;
+        }
+        else {
+            std::move(begin() + index + 1, end(), begin() + index);
+            PopBack();
+        }
+        return begin() + index;
+    }
+
+    iterator Insert(const_iterator pos, const T& value) {
+        return Emplace(pos, value);
+    }
+
+    iterator Insert(const_iterator pos, T&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    void PopBack() noexcept {
+        assert(size_ != 0);
+        --size_;
+        AllocTraits::destroy(heap_.GetAllocator(), end());
+    }
+
+    void Swap(SmallVector& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (!IsInline() && !other.IsInline()) {
+            assert(GetAllocator() == other.GetAllocator());
+            heap_.Swap(other.heap_);
+            std::swap(size_, other.size_);
+            return;
+        }
+        SmallVector temp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(temp);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return IsInline() ? N : heap_.Capacity();
+    }
+
+    // Возвращает true, пока элементы хранятся во встроенном буфере
+    bool IsInline() const noexcept {
+        return heap_.GetAddress() == nullptr;
+    }
+
+    Allocator GetAllocator() const noexcept {
+        return heap_.GetAllocator();
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<SmallVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return Data()[index];
+    }
+
+private:
+    static constexpr bool kRelocatesBitwise = is_trivially_relocatable_v<T> && !allocator_customizes_construct_v<Allocator>;
+
+    T* Data() noexcept {
+        return IsInline() ? std::launder(reinterpret_cast<T*>(inline_)) : heap_.GetAddress();
+    }
+
+    // Забирает элементы other в пустой вектор. Динамический буфер other забирается целиком,
+    // элементы встроенного буфера переносятся поштучно
+    void MoveFrom(SmallVector& other) {
+        assert(size_ == 0);
+        if (!other.IsInline() && GetAllocator() == other.GetAllocator()) {
+            heap_.Swap(other.heap_);
+        }
+        else {
+            Reserve(other.size_);
+            RelocateUninitializedN(heap_.GetAllocator(), other.begin(), other.size_, begin());
+        }
+        size_ = std::exchange(other.size_, 0);
+    }
+
+    alignas(T) unsigned char inline_[N * sizeof(T)];
+    RawMemory<T, Allocator> heap_;
+    size_t size_ = 0;
+};
\ No newline at end of file
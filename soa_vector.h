@@ -0,0 +1,294 @@
+#pragma once
+#include "index_iterator.h"
+#include "vector.h"
+
+#include <tuple>
+
+// Вектор записей, хранящий каждое поле в отдельном столбце RawMemory (struct of arrays).
+// Все столбцы имеют общие размер и вместимость и растут вместе. Цикл, читающий лишь пару
+// полей, загружает в кэш только их столбцы, а не записи целиком.
+// Column<I>() отдаёт столбец как std::span, а итератор и operator[] — кортеж ссылок на поля записи
+template <typename... Ts>
+class SoAVector {
+    static_assert(sizeof...(Ts) > 0, "SoAVector needs at least one column");
+
+    using Indices = std::index_sequence_for<Ts...>;
+
+public:
+    using value_type = std::tuple<Ts...>;
+    using reference = std::tuple<Ts&...>;
+    using const_reference = std::tuple<const Ts&...>;
+    // Итератор хранит индекс записи и при разыменовании собирает кортеж ссылок на её поля
+    using iterator = IndexIterator<SoAVector, false>;
+    using const_iterator = IndexIterator<SoAVector, true>;
+
+    template <size_t I>
+    using ColumnType = std::tuple_element_t<I, value_type>;
+
+    SoAVector() = default;
+
+    SoAVector(const SoAVector& other)
+        : columns_(RawMemory<Ts>(other.size_)...)
+    {
+        CopyColumns(other, Indices{});
+        size_ = other.size_;
+    }
+
+    SoAVector(SoAVector&& other) noexcept
+        : columns_(std::move(other.columns_))
+        , size_(std::exchange(other.size_, 0))
+    {
+    }
+
+    ~SoAVector() {
+        Clear();
+    }
+
+    SoAVector& operator=(const SoAVector& rhs) {
+        if (this != &rhs) {
+            SoAVector rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    SoAVector& operator=(SoAVector&& rhs) noexcept {
+        if (this != &rhs) {
+            Clear();
+            columns_ = std::move(rhs.columns_);
+            size_ = std::exchange(rhs.size_, 0);
+        }
+        return *this;
+    }
+
+    iterator begin() noexcept {
+        return iterator(this, 0);
+    }
+
+    iterator end() noexcept {
+        return iterator(this, size_);
+    }
+
+    const_iterator begin() const noexcept {
+        return cbegin();
+    }
+
+    const_iterator end() const noexcept {
+        return cend();
+    }
+
+    const_iterator cbegin() const noexcept {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator cend() const noexcept {
+        return const_iterator(this, size_);
+    }
+
+    template <size_t I>
+    std::span<ColumnType<I>> Column() noexcept {
+        return std::span<ColumnType<I>>(std::get<I>(columns_).GetAddress(), size_);
+    }
+
+    template <size_t I>
+    std::span<const ColumnType<I>> Column() const noexcept {
+        return std::span<const ColumnType<I>>(std::get<I>(columns_).GetAddress(), size_);
+    }
+
+    // Перевыделяет все столбцы сразу. Если перенос какого-то столбца бросит исключение,
+    // вектор остаётся прежним
+    void Reserve(size_t new_capacity) {
+        if (new_capacity <= Capacity()) {
+            return;
+        }
+        std::tuple<RawMemory<Ts>...> new_columns{RawMemory<Ts>(new_capacity)...};
+        RelocateColumns(new_columns, Indices{});
+        columns_.swap(new_columns);
+    }
+
+    void Resize(size_t new_size) {
+        while (size_ > new_size) {
+            PopBack();
+        }
+        Reserve(new_size);
+        while (size_ < new_size) {
+            EmplaceBack(Ts()...);
+        }
+    }
+
+    // Добавляет запись из значений полей, по одному аргументу на каждый столбец
+    template <typename... Args>
+        requires(sizeof...(Args) == sizeof...(Ts))
+    reference EmplaceBack(Args&&... args) {
+        if (size_ == Capacity()) {
+            // Аргументы могут ссылаться на элементы вектора, поэтому запись собирается до перевыделения
+            value_type values(std::forward<Args>(args)...);
+            Reserve(DoublingGrowth::NextCapacity<value_type>(Capacity(), size_ + 1));
+            std::apply([this](Ts&... fields) {
+                ConstructAtEnd(Indices{}, std::move(fields)...);
+            }, values);
+        }
+        else {
+            ConstructAtEnd(Indices{}, std::forward<Args>(args)...);
+        }
+        ++size_;
+        return (*this)[size_ - 1];
+    }
+
+    void PushBack(const value_type& values) {
+        std::apply([this](const Ts&... fields) {
+            EmplaceBack(fields...);
+        }, values);
+    }
+
+    void PushBack(value_type&& values) {
+        std::apply([this](Ts&... fields) {
+            EmplaceBack(std::move(fields)...);
+        }, values);
+    }
+
+    void PopBack() noexcept {
+        assert(size_ != 0);
+        --size_;
+        DestroyAt(size_, Indices{});
+    }
+
+    // Столбцы сдвигаются по очереди, и уже сдвинутые при ошибке в следующем не вернуть без
+    // риска нового исключения. Поэтому сдвиг каждого столбца обязан обходиться без исключений
+    iterator Erase(const_iterator pos) noexcept {
+        static_assert(((is_trivially_relocatable_v<Ts> || std::is_nothrow_move_assignable_v<Ts>) && ...),
+                      "SoAVector::Erase requires every column to be nothrow move assignable");
+        assert(cbegin() <= pos && pos < cend());
+        const size_t index = pos - cbegin();
+        EraseColumns(index, Indices{});
+        --size_;
+        return begin() + index;
+    }
+
+    // Уничтожает все записи, сохраняя столбцы для повторного использования
+    void Clear() noexcept {
+        DestroyColumns(Indices{});
+        size_ = 0;
+    }
+
+    void Swap(SoAVector& other) noexcept {
+        columns_.swap(other.columns_);
+        std::swap(size_, other.size_);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return std::get<0>(columns_).Capacity();
+    }
+
+    reference operator[](size_t index) noexcept {
+        assert(index < size_);
+        return Row(index, Indices{});
+    }
+
+    const_reference operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return Row(index, Indices{});
+    }
+
+private:
+    template <size_t... Is>
+    reference Row(size_t index, std::index_sequence<Is...>) noexcept {
+        return reference(std::get<Is>(columns_)[index]...);
+    }
+
+    template <size_t... Is>
+    const_reference Row(size_t index, std::index_sequence<Is...>) const noexcept {
+        return const_reference(std::get<Is>(columns_)[index]...);
+    }
+
+    // Создаёт поля новой записи в позиции size_. Если поле бросит исключение,
+    // уже созданные поля этой записи уничтожаются
+    template <size_t... Is, typename... Args>
+    void ConstructAtEnd(std::index_sequence<Is...>, Args&&... args) {
+        size_t constructed = 0;
+        try {
+            ((new (std::get<Is>(columns_) + size_) Ts(std::forward<Args>(args)), ++constructed), ...);
+        }
+        catch (...) {
+            ((Is < constructed ? std::destroy_at(std::get<Is>(columns_) + size_) : void()), ...);
+            throw;
+        }
+    }
+
+    template <size_t... Is>
+    void DestroyAt(size_t index, std::index_sequence<Is...>) noexcept {
+        (std::destroy_at(std::get<Is>(columns_) + index), ...);
+    }
+
+    template <size_t... Is>
+    void DestroyColumns(std::index_sequence<Is...>) noexcept {
+        (std::destroy_n(std::get<Is>(columns_).GetAddress(), size_), ...);
+    }
+
+    template <size_t... Is>
+    void CopyColumns(const SoAVector& other, std::index_sequence<Is...>) {
+        size_t copied = 0;
+        try {
+            ((CopyUninitializedN(std::get<Is>(other.columns_).GetAddress(), other.size_, std::get<Is>(columns_).GetAddress()),
+              ++copied), ...);
+        }
+        catch (...) {
+            ((Is < copied ? (void)std::destroy_n(std::get<Is>(columns_).GetAddress(), other.size_) : void()), ...);
+            throw;
+        }
+    }
+
+    // Столбец переносится с возможным исключением, только если его элементы приходится копировать
+    template <typename T>
+    static constexpr bool kRelocationMayThrow = !is_trivially_relocatable_v<T> && !std::is_nothrow_move_constructible_v<T>
+                                                && std::is_copy_constructible_v<T>;
+
+    // Сначала копируются столбцы, перенос которых может бросить исключение: при ошибке их копии
+    // уничтожаются, а исходные элементы ещё не тронуты. Остальные столбцы переносятся без исключений
+    template <size_t... Is>
+    void RelocateColumns(std::tuple<RawMemory<Ts>...>& to, std::index_sequence<Is...>) {
+        size_t copied = 0;
+        try {
+            ((kRelocationMayThrow<Ts> ? (CopyColumn<Is>(to), ++copied) : 0), ...);
+        }
+        catch (...) {
+            size_t destroyed = 0;
+            ((kRelocationMayThrow<Ts> && destroyed++ < copied ? (void)std::destroy_n(std::get<Is>(to).GetAddress(), size_) : void()),
+             ...);
+            throw;
+        }
+        ((kRelocationMayThrow<Ts> ? (void)std::destroy_n(std::get<Is>(columns_).GetAddress(), size_)
+                                  : RelocateUninitializedN(std::get<Is>(columns_).GetAddress(), size_, std::get<Is>(to).GetAddress())),
+         ...);
+    }
+
+    template <size_t I>
+    void CopyColumn(std::tuple<RawMemory<Ts>...>& to) {
+        InitializeWithCopyMoveUninitializedN(std::get<I>(columns_).GetAddress(), size_, std::get<I>(to).GetAddress());
+    }
+
+    template <size_t... Is>
+    void EraseColumns(size_t index, std::index_sequence<Is...>) noexcept {
+        (EraseInColumn<Ts>(std::get<Is>(columns_).GetAddress(), index), ...);
+    }
+
+    template <typename T>
+    void EraseInColumn(T* column, size_t index) noexcept {
+        if constexpr (is_trivially_relocatable_v<T>) {
+            std::destroy_at(column + index);
+            std::memmove(static_cast<void*>(column + index), static_cast<const void*>(column + index + 1),
+                         (size_ - index - 1) * sizeof(T));
+        }
+        else {
+            std::move(column + index + 1, column + size_, column + index);
+            std::destroy_at(column + size_ - 1);
+        }
+    }
+
+    std::tuple<RawMemory<Ts>...> columns_;
+    size_t size_ = 0;
+};
\ No newline at end of file
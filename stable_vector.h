@@ -0,0 +1,227 @@
+#pragma once
+#include "index_iterator.h"
+#include "vector.h"
+
+// Размер блока по умолчанию: около 4 КиБ элементов, округлённый до степени двойки
+template <typename T>
+inline constexpr size_t kDefaultStableChunkSize = std::bit_ceil(std::max<size_t>(4096 / sizeof(T), 1));
+
+// Вектор из блоков RawMemory фиксированного размера ChunkSize и таблицы этих блоков.
+// При росте добавляется новый блок, а существующие элементы никогда не перемещаются,
+// поэтому указатели, ссылки и итераторы на них остаются действительными до удаления
+// самих элементов. Доступ по индексу — O(1), добавление в конец — O(1) без переноса элементов
+template <typename T, size_t ChunkSize = kDefaultStableChunkSize<T>, typename Allocator = std::allocator<T>>
+class StableVector {
+    static_assert(std::has_single_bit(ChunkSize), "ChunkSize must be a power of two");
+    using AllocTraits = std::allocator_traits<Allocator>;
+
+public:
+    using allocator_type = Allocator;
+    using value_type = T;
+    using reference = T&;
+    using const_reference = const T&;
+    // Итератор хранит индекс, а не указатель: так он переживает переход между блоками
+    // и остаётся действительным при добавлении элементов
+    using iterator = IndexIterator<StableVector, false>;
+    using const_iterator = IndexIterator<StableVector, true>;
+
+    StableVector() = default;
+
+    explicit StableVector(const Allocator& alloc) noexcept
+        : alloc_(alloc)
+    {
+    }
+
+    explicit StableVector(size_t size, const Allocator& alloc = Allocator())
+        : StableVector(alloc)
+    {
+        Resize(size);
+    }
+
+    StableVector(const StableVector& other)
+        : StableVector(other, AllocTraits::select_on_container_copy_construction(other.alloc_))
+    {
+    }
+
+    StableVector(const StableVector& other, const Allocator& alloc)
+        : StableVector(alloc)
+    {
+        Reserve(other.size_);
+        for (const T& value : other) {
+            EmplaceBack(value);
+        }
+    }
+
+    StableVector(StableVector&& other) noexcept
+        : alloc_(other.alloc_)
+        , chunks_(std::move(other.chunks_))
+        , size_(std::exchange(other.size_, 0))
+    {
+    }
+
+    ~StableVector() {
+        Clear();
+    }
+
+    // Копии создаются в блоках того аллокатора, который останется у вектора после присваивания
+    StableVector& operator=(const StableVector& rhs) {
+        if (this != &rhs) {
+            constexpr bool kPropagate = AllocTraits::propagate_on_container_copy_assignment::value;
+            StableVector rhs_copy(rhs, kPropagate ? rhs.alloc_ : alloc_);
+            SwapStorage(rhs_copy);
+        }
+        return *this;
+    }
+
+    // Блоки rhs можно забрать, только если аллокатор переходит вместе с ними или аллокаторы равны,
+    // иначе элементы перемещаются поштучно в блоки своего аллокатора
+    StableVector& operator=(StableVector&& rhs) noexcept(AllocTraits::propagate_on_container_move_assignment::value
+                                                         || AllocTraits::is_always_equal::value) {
+        if (this != &rhs) {
+            if constexpr (!AllocTraits::propagate_on_container_move_assignment::value
+                          && !AllocTraits::is_always_equal::value) {
+                if (alloc_ != rhs.alloc_) {
+                    StableVector rhs_moved(alloc_);
+                    rhs_moved.Reserve(rhs.size_);
+                    for (T& value : rhs) {
+                        rhs_moved.EmplaceBack(std::move(value));
+                    }
+                    SwapStorage(rhs_moved);
+                    return *this;
+                }
+            }
+            Clear();
+            // Каждый блок освобождается копией аллокатора, которым он был выделен
+            chunks_ = std::move(rhs.chunks_);
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+                alloc_ = rhs.alloc_;
+            }
+            size_ = std::exchange(rhs.size_, 0);
+        }
+        return *this;
+    }
+
+    iterator begin() noexcept {
+        return iterator(this, 0);
+    }
+
+    iterator end() noexcept {
+        return iterator(this, size_);
+    }
+
+    const_iterator begin() const noexcept {
+        return cbegin();
+    }
+
+    const_iterator end() const noexcept {
+        return cend();
+    }
+
+    const_iterator cbegin() const noexcept {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator cend() const noexcept {
+        return const_iterator(this, size_);
+    }
+
+    // Выделяет блоки под new_capacity элементов; уже созданные элементы остаются на месте
+    void Reserve(size_t new_capacity) {
+        const size_t chunk_count = (new_capacity + ChunkSize - 1) / ChunkSize;
+        chunks_.Reserve(chunk_count);
+        while (chunks_.Size() < chunk_count) {
+            chunks_.EmplaceBack(ChunkSize, alloc_);
+        }
+    }
+
+    void Resize(size_t new_size) {
+        while (size_ > new_size) {
+            PopBack();
+        }
+        Reserve(new_size);
+        while (size_ < new_size) {
+            EmplaceBack();
+        }
+    }
+
+    void PushBack(const T& value) {
+        (void)EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        (void)EmplaceBack(std::move(value));
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        if (size_ == Capacity()) {
+            chunks_.EmplaceBack(ChunkSize, alloc_);
+        }
+        T* element = Slot(size_);
+        AllocTraits::construct(alloc_, element, std::forward<Args>(args)...);
+        ++size_;
+        return *element;
+    }
+
+    void PopBack() noexcept {
+        assert(size_ != 0);
+        --size_;
+        AllocTraits::destroy(alloc_, Slot(size_));
+    }
+
+    // Уничтожает все элементы, сохраняя блоки для повторного использования
+    void Clear() noexcept {
+        while (size_ != 0) {
+            PopBack();
+        }
+    }
+
+    void Swap(StableVector& other) noexcept {
+        // Без propagate_on_container_swap обмен допустим только между равными аллокаторами
+        assert(AllocTraits::propagate_on_container_swap::value || alloc_ == other.alloc_);
+        SwapStorage(other);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return chunks_.Size() * ChunkSize;
+    }
+
+    Allocator GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<StableVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return *Slot(index);
+    }
+
+private:
+    static constexpr size_t kChunkShift = std::countr_zero(ChunkSize);
+
+    T* Slot(size_t index) noexcept {
+        return chunks_[index >> kChunkShift].GetAddress() + (index & (ChunkSize - 1));
+    }
+
+    // Обменивает блоки, размеры и аллокаторы. Каждый блок хранит копию аллокатора,
+    // которым он выделен, поэтому блоки можно передавать между векторами с разными аллокаторами
+    void SwapStorage(StableVector& other) noexcept {
+        if constexpr (std::is_swappable_v<Allocator>) {
+            using std::swap;
+            swap(alloc_, other.alloc_);
+        }
+        chunks_.Swap(other.chunks_);
+        std::swap(size_, other.size_);
+    }
+
+    [[no_unique_address]] Allocator alloc_;
+    Vector<RawMemory<T, Allocator>> chunks_;
+    size_t size_ = 0;
+};
\ No newline at end of file
@@ -0,0 +1,438 @@
+// Регрессионные проверки утечек: после каждой публичной операции контейнера аллокатор со счётчиком
+// должен держать ровно буфер контейнера, а число созданных элементов — совпадать с числом
+// уничтоженных. Каждая операция повторяется с исключением, внедрённым по очереди в каждое
+// выделение памяти и каждое создание или присваивание элемента, пока не пройдёт без исключения.
+// Сборка: g++ -std=c++20 -O1 -g -fsanitize=address,undefined -I.. allocation_test.cpp -o allocation_test
+// Запуск: ./allocation_test — печатает нарушенные проверки и завершается с ненулевым кодом
+
+#include "../small_vector.h"
+#include "../stable_vector.h"
+#include "../vector.h"
+
+#include <array>
+#include <cstdio>
+#include <exception>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+struct Counters {
+    long long outstanding_bytes = 0;
+    long long live_elements = 0;
+    // Сколько ещё выделений и созданий элементов пройдёт до внедрённого исключения; -1 — не бросать
+    long long failure_countdown = -1;
+    int failed_checks = 0;
+};
+
+Counters counters;
+
+struct InjectedFailure : std::exception {
+};
+
+void MaybeInjectFailure() {
+    if (counters.failure_countdown >= 0 && counters.failure_countdown-- == 0) {
+        throw InjectedFailure();
+    }
+}
+
+// Аллокаторы с разными id не равны: буфер, выделенный одним, другой освободить не может
+template <typename T>
+class CountingAllocator {
+public:
+    using value_type = T;
+
+    explicit CountingAllocator(int id = 0) noexcept
+        : id_(id)
+    {
+    }
+
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>& other) noexcept
+        : id_(other.Id())
+    {
+    }
+
+    T* allocate(size_t n) {
+        MaybeInjectFailure();
+        T* p = std::allocator<T>().allocate(n);
+        counters.outstanding_bytes += static_cast<long long>(n * sizeof(T));
+        return p;
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        counters.outstanding_bytes -= static_cast<long long>(n * sizeof(T));
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    int Id() const noexcept {
+        return id_;
+    }
+
+    template <typename U>
+    bool operator==(const CountingAllocator<U>& other) const noexcept {
+        return id_ == other.Id();
+    }
+
+private:
+    int id_;
+};
+
+// Аллокатор со счётчиком, который переходит к контейнеру при присваивании и обмене
+template <typename T>
+class PropagatingAllocator : public CountingAllocator<T> {
+public:
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    using CountingAllocator<T>::CountingAllocator;
+};
+
+// Элемент, считающий живые экземпляры. Если перемещение может бросить исключение,
+// контейнеры при перевыделении копируют элементы, и проверяется вторая ветка реализации
+template <bool NothrowMove>
+class Tracked {
+public:
+    Tracked(int value = 0)
+        : value_(value)
+    {
+        MaybeInjectFailure();
+        ++counters.live_elements;
+    }
+
+    Tracked(const Tracked& other)
+        : value_(other.value_)
+    {
+        MaybeInjectFailure();
+        ++counters.live_elements;
+    }
+
+    Tracked(Tracked&& other) noexcept(NothrowMove)
+        : value_(other.value_)
+    {
+        if constexpr (!NothrowMove) {
+            MaybeInjectFailure();
+        }
+        ++counters.live_elements;
+    }
+
+    Tracked& operator=(const Tracked& other) {
+        MaybeInjectFailure();
+        value_ = other.value_;
+        return *this;
+    }
+
+    Tracked& operator=(Tracked&& other) noexcept(NothrowMove) {
+        if constexpr (!NothrowMove) {
+            MaybeInjectFailure();
+        }
+        value_ = other.value_;
+        return *this;
+    }
+
+    ~Tracked() {
+        --counters.live_elements;
+    }
+
+    int Value() const noexcept {
+        return value_;
+    }
+
+private:
+    int value_;
+};
+
+void Check(bool condition, const char* operation, const char* what, long long failure_at) {
+    if (!condition) {
+        std::printf("FAILED %s (failure injected at %lld): %s\n", operation, failure_at, what);
+        ++counters.failed_checks;
+    }
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+long long HeapBytes(const Vector<T, Allocator, GrowthPolicy>& vector) {
+    return static_cast<long long>(vector.Capacity() * sizeof(T));
+}
+
+template <typename T, size_t N, typename Allocator>
+long long HeapBytes(const SmallVector<T, N, Allocator>& vector) {
+    return vector.IsInline() ? 0 : static_cast<long long>(vector.Capacity() * sizeof(T));
+}
+
+// Таблица блоков выделяется std::allocator и не учитывается
+template <typename T, size_t ChunkSize, typename Allocator>
+long long HeapBytes(const StableVector<T, ChunkSize, Allocator>& vector) {
+    return static_cast<long long>(vector.Capacity() * sizeof(T));
+}
+
+// Строит контейнер из size элементов с вместимостью не меньше capacity, без внедрения исключений
+template <typename Container>
+Container MakeFilled(size_t size, size_t capacity, int allocator_id = 0) {
+    Container container{typename Container::allocator_type(allocator_id)};
+    container.Reserve(capacity);
+    for (size_t i = 0; i < size; ++i) {
+        container.PushBack(static_cast<int>(i));
+    }
+    return container;
+}
+
+// Выполняет operation над заполненным контейнером, внедряя исключение в k-е выделение или
+// создание элемента для k = 0, 1, 2, ..., пока операция не пройдёт без исключения. После каждой
+// попытки живых элементов должно быть ровно столько, сколько их в контейнере, а памяти выделено
+// ровно под его буфер; после уничтожения контейнера не должно остаться ни того, ни другого
+template <typename Container, typename Operation>
+void CheckOperation(const char* name, size_t size, size_t capacity, Operation operation) {
+    for (long long failure_at = 0;; ++failure_at) {
+        bool failed = false;
+        {
+            Container container = MakeFilled<Container>(size, capacity);
+            counters.failure_countdown = failure_at;
+            try {
+                operation(container);
+            }
+            catch (const InjectedFailure&) {
+                failed = true;
+            }
+            counters.failure_countdown = -1;
+            Check(counters.live_elements == static_cast<long long>(container.Size()), name,
+                  "live elements differ from size", failure_at);
+            Check(counters.outstanding_bytes == HeapBytes(container), name,
+                  "allocated bytes differ from the buffer", failure_at);
+        }
+        Check(counters.live_elements == 0, name, "elements leaked", failure_at);
+        Check(counters.outstanding_bytes == 0, name, "memory leaked", failure_at);
+        counters.live_elements = 0;
+        counters.outstanding_bytes = 0;
+        if (!failed) {
+            return;
+        }
+    }
+}
+
+// Операции, общие для Vector и SmallVector. Контейнер проверяется заполненным до конца
+// вместимости и со свободным местом, чтобы пройти и ветки с перевыделением, и без него
+template <typename Container>
+void CheckCommonOperations(size_t size, size_t capacity) {
+    using Element = std::iter_value_t<typename Container::iterator>;
+    auto check = [size, capacity](const char* name, auto operation) {
+        CheckOperation<Container>(name, size, capacity, operation);
+    };
+    check("copy construction", [](Container& c) {
+        Container copy(c);
+    });
+    check("copy assignment to a shorter container", [](Container& c) {
+        Container other = MakeFilled<Container>(2, 2);
+        other = c;
+    });
+    check("copy assignment from a shorter container", [](Container& c) {
+        Container other = MakeFilled<Container>(2, 2);
+        c = other;
+    });
+    check("copy assignment from a longer container", [](Container& c) {
+        Container other = MakeFilled<Container>(c.Size() + 5, c.Size() + 5);
+        c = other;
+    });
+    check("copy assignment from a shorter container with an unequal allocator", [](Container& c) {
+        Container other = MakeFilled<Container>(2, 2, 1);
+        c = other;
+    });
+    check("copy assignment from a longer container with an unequal allocator", [](Container& c) {
+        Container other = MakeFilled<Container>(c.Size() + 5, c.Size() + 5, 1);
+        c = other;
+    });
+    check("copy assignment to a container with an unequal allocator", [](Container& c) {
+        Container other = MakeFilled<Container>(2, 2, 1);
+        other = c;
+    });
+    check("move construction", [](Container& c) {
+        Container moved(std::move(c));
+    });
+    check("move assignment", [](Container& c) {
+        Container other = MakeFilled<Container>(3, 3);
+        c = std::move(other);
+    });
+    check("move assignment from an unequal allocator", [](Container& c) {
+        Container other = MakeFilled<Container>(c.Size() + 3, c.Size() + 3, 1);
+        c = std::move(other);
+    });
+    check("self move assignment", [](Container& c) {
+        Container& self = c;
+        c = std::move(self);
+    });
+    check("swap", [](Container& c) {
+        Container other = MakeFilled<Container>(3, 3);
+        c.Swap(other);
+    });
+    check("Reserve", [](Container& c) {
+        c.Reserve(c.Capacity() + 10);
+    });
+    check("Resize up", [](Container& c) {
+        c.Resize(c.Size() + 7);
+    });
+    check("Resize down", [](Container& c) {
+        c.Resize(c.Size() / 2);
+    });
+    check("PushBack", [](Container& c) {
+        c.PushBack(Element(42));
+    });
+    check("EmplaceBack of an own element", [](Container& c) {
+        c.EmplaceBack(c[0]);
+    });
+    check("Emplace in the middle", [](Container& c) {
+        c.Emplace(c.begin() + 1, 42);
+    });
+    check("Insert of an own element", [](Container& c) {
+        c.Insert(c.begin(), c[c.Size() - 1]);
+    });
+    check("Erase", [](Container& c) {
+        c.Erase(c.begin() + 1);
+    });
+    check("PopBack", [](Container& c) {
+        c.PopBack();
+    });
+}
+
+template <typename Container>
+void CheckVectorOperations(size_t size, size_t capacity) {
+    using Element = std::iter_value_t<typename Container::iterator>;
+    auto check = [size, capacity](const char* name, auto operation) {
+        CheckOperation<Container>(name, size, capacity, operation);
+    };
+    check("copy construction with another allocator", [](Container& c) {
+        Container copy(c, typename Container::allocator_type(1));
+    });
+    check("move construction with another allocator", [](Container& c) {
+        Container moved(std::move(c), typename Container::allocator_type(1));
+    });
+    check("Resize up with an own element", [](Container& c) {
+        c.Resize(c.Size() + 7, c[0]);
+    });
+    check("Resize down with a value", [](Container& c) {
+        c.Resize(c.Size() / 2, Element(7));
+    });
+    check("ResizeForOverwrite", [](Container& c) {
+        c.ResizeForOverwrite(c.Size() + 3);
+    });
+    check("ShrinkToFit", [](Container& c) {
+        c.PopBack();
+        c.ShrinkToFit();
+    });
+    check("Clear", [](Container& c) {
+        c.Clear();
+    });
+    check("Insert of copies", [](Container& c) {
+        c.Insert(c.begin() + 1, 3, Element(7));
+    });
+    check("Insert of a range", [](Container& c) {
+        const std::array<Element, 3> values{1, 2, 3};
+        c.Insert(c.begin() + 2, values.begin(), values.end());
+    });
+    check("Erase of a range", [](Container& c) {
+        c.Erase(c.begin() + 1, c.begin() + 3);
+    });
+    check("EraseIf", [](Container& c) {
+        c.EraseIf([](const Element& element) {
+            return element.Value() % 2 == 0;
+        });
+    });
+    check("EraseIndices", [](Container& c) {
+        const std::array<size_t, 3> indices{0, 2, 3};
+        c.EraseIndices(indices);
+    });
+}
+
+template <typename Container>
+void CheckStableVectorOperations(size_t size, size_t capacity) {
+    using Element = std::iter_value_t<typename Container::iterator>;
+    auto check = [size, capacity](const char* name, auto operation) {
+        CheckOperation<Container>(name, size, capacity, operation);
+    };
+    check("copy construction", [](Container& c) {
+        Container copy(c);
+    });
+    check("copy assignment from a shorter container", [](Container& c) {
+        Container other = MakeFilled<Container>(2, 2);
+        c = other;
+    });
+    check("copy assignment from a longer container", [](Container& c) {
+        Container other = MakeFilled<Container>(c.Size() + 5, c.Size() + 5);
+        c = other;
+    });
+    check("copy assignment from an unequal allocator", [](Container& c) {
+        Container other = MakeFilled<Container>(c.Size() + 5, c.Size() + 5, 1);
+        c = other;
+    });
+    check("move assignment", [](Container& c) {
+        Container other = MakeFilled<Container>(3, 3);
+        c = std::move(other);
+    });
+    check("move assignment from an unequal allocator", [](Container& c) {
+        Container other = MakeFilled<Container>(c.Size() + 3, c.Size() + 3, 1);
+        c = std::move(other);
+    });
+    check("Reserve", [](Container& c) {
+        c.Reserve(c.Capacity() + 10);
+    });
+    check("Resize up", [](Container& c) {
+        c.Resize(c.Size() + 7);
+    });
+    check("Resize down", [](Container& c) {
+        c.Resize(c.Size() / 2);
+    });
+    check("PushBack", [](Container& c) {
+        c.PushBack(Element(42));
+    });
+    check("PopBack", [](Container& c) {
+        c.PopBack();
+    });
+    check("Clear", [](Container& c) {
+        c.Clear();
+    });
+}
+
+template <typename Element, template <typename> typename Allocator>
+void CheckVector() {
+    using Container = Vector<Element, Allocator<Element>>;
+    for (size_t capacity : {8, 12}) {
+        CheckCommonOperations<Container>(8, capacity);
+        CheckVectorOperations<Container>(8, capacity);
+    }
+}
+
+template <typename Element, template <typename> typename Allocator>
+void CheckSmallVector() {
+    using Container = SmallVector<Element, 4, Allocator<Element>>;
+    // Встроенный буфер целиком, встроенный буфер со свободным местом и динамическая память
+    CheckCommonOperations<Container>(4, 4);
+    CheckCommonOperations<Container>(3, 4);
+    CheckCommonOperations<Container>(8, 12);
+}
+
+template <typename Element>
+void CheckStableVector() {
+    using Container = StableVector<Element, 4, CountingAllocator<Element>>;
+    CheckStableVectorOperations<Container>(8, 8);
+    CheckStableVectorOperations<Container>(6, 12);
+}
+
+}  // namespace
+
+int main() {
+    CheckVector<Tracked<true>, CountingAllocator>();
+    CheckVector<Tracked<false>, CountingAllocator>();
+    CheckVector<Tracked<true>, PropagatingAllocator>();
+    CheckVector<Tracked<false>, PropagatingAllocator>();
+    CheckSmallVector<Tracked<true>, CountingAllocator>();
+    CheckSmallVector<Tracked<false>, CountingAllocator>();
+    CheckSmallVector<Tracked<true>, PropagatingAllocator>();
+    CheckSmallVector<Tracked<false>, PropagatingAllocator>();
+    CheckStableVector<Tracked<true>>();
+    CheckStableVector<Tracked<false>>();
+    if (counters.failed_checks != 0) {
+        std::printf("%d checks failed\n", counters.failed_checks);
+        return 1;
+    }
+    std::printf("all checks passed\n");
+}
\ No newline at end of file
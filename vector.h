@@ -1,161 +1,713 @@
 #pragma once
 #include <cassert>
 #include <cstdlib>
+#include <cstring>
 #include <new>
 #include <utility>
 #include <memory>
+#include <memory_resource>
+#include <span>
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
 
+#include "vector_parallel.h"
+#include "vector_stats.h"
+
+// Тип тривиально перемещаем, если объект можно перенести на новое место побайтовым копированием,
+// не вызывая ни конструктор перемещения, ни деструктор исходного объекта. Для тривиально копируемых
+// типов это определяется автоматически, остальные типы могут явно специализировать шаблон
+template <typename T>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<T> {};
+
+template <typename T>
+struct IsTriviallyRelocatable<std::unique_ptr<T>> : std::true_type {};
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v = IsTriviallyRelocatable<T>::value;
+
+// Аллокатор может дополнительно предоставлять reallocate(p, old_n, new_n): изменение размера блока
+// с побайтовым переносом содержимого, как у realloc или mremap. Им пользуются только для
+// тривиально перемещаемых элементов, которые не требуется перемещать конструктором
+template <typename Allocator>
+inline constexpr bool allocator_supports_reallocate_v = requires(Allocator& alloc,
+                                                                 typename Allocator::value_type* p,
+                                                                 size_t n) {
+    { alloc.reallocate(p, n, n) } -> std::same_as<typename Allocator::value_type*>;
+};
+
+// Аллокатор может дополнительно предоставлять good_size(n): сколько элементов на самом деле
+// поместится в блок, выделенный под n элементов, как malloc_good_size или nallocx.
+// Им пользуется SizeClassGrowth, чтобы вместимость вектора занимала блок целиком
+template <typename Allocator>
+inline constexpr bool allocator_has_good_size_v = requires(const Allocator& alloc, size_t n) {
+    { alloc.good_size(n) } -> std::convertible_to<size_t>;
+};
+
+// Аллокатор с собственными construct или destroy сам создаёт и уничтожает элементы: например,
+// std::pmr::polymorphic_allocator передаёт свой ресурс элементам-строкам. Элементы таких
+// аллокаторов создаются только через std::allocator_traits, без memcpy и побайтового переноса
+template <typename Allocator>
+inline constexpr bool allocator_customizes_construct_v = requires(Allocator& alloc, typename Allocator::value_type* p) {
+    alloc.destroy(p);
+} || requires(Allocator& alloc, typename Allocator::value_type* p, typename Allocator::value_type&& value) {
+    alloc.construct(p, std::move(value));
+};
+
+// Тривиально копируемым элементам polymorphic_allocator ничего не передаёт, и его construct
+// не отличается от std::construct_at
 template <typename T>
+inline constexpr bool allocator_customizes_construct_v<std::pmr::polymorphic_allocator<T>> = !std::is_trivially_copyable_v<T>;
+
+template <typename T, typename Allocator = std::allocator<T>>
 class RawMemory {
+    using AllocTraits = std::allocator_traits<Allocator>;
+    static_assert(std::is_same_v<typename AllocTraits::value_type, T>,
+                  "Allocator::value_type must be the same as T");
+
 public:
+    using allocator_type = Allocator;
+
     RawMemory() = default;
 
-    explicit RawMemory(size_t capacity)
-        : buffer_(Allocate(capacity))
+    constexpr explicit RawMemory(const Allocator& alloc) noexcept
+        : alloc_(alloc) {
+    }
+
+    constexpr explicit RawMemory(size_t capacity, const Allocator& alloc = Allocator())
+        : alloc_(alloc)
+        , buffer_(Allocate(capacity))
         , capacity_(capacity) {
     }
 
-    ~RawMemory() {
-        Deallocate(buffer_);
+    constexpr ~RawMemory() {
+        Deallocate(buffer_, capacity_);
     }
 
     RawMemory(const RawMemory&) = delete;
     RawMemory& operator=(const RawMemory& rhs) = delete;
 
-    RawMemory(RawMemory&& other) noexcept { 
+    // Буфер переезжает вместе с аллокатором, которым он был выделен. Неприсваиваемые
+    // аллокаторы (например, std::pmr::polymorphic_allocator) остаются на месте, и тогда
+    // владелец RawMemory обязан сам убедиться, что аллокаторы равны
+    constexpr RawMemory(RawMemory&& other) noexcept
+        : alloc_(std::move(other.alloc_)) {
         buffer_ = std::exchange(other.buffer_, nullptr);
         capacity_ = std::exchange(other.capacity_, 0);
     }
 
-    RawMemory& operator=(RawMemory&& rhs) noexcept { 
-        buffer_ = std::exchange(rhs.buffer_, nullptr);
-        capacity_ = std::exchange(rhs.capacity_, 0);
+    constexpr RawMemory& operator=(RawMemory&& rhs) noexcept { 
+        if (this != &rhs) {
+            // Текущий буфер освобождается своим аллокатором до того, как тот будет заменён
+            Deallocate(buffer_, capacity_);
+            if constexpr (std::is_move_assignable_v<Allocator>) {
+                alloc_ = std::move(rhs.alloc_);
+            }
+            buffer_ = std::exchange(rhs.buffer_, nullptr);
+            capacity_ = std::exchange(rhs.capacity_, 0);
+        }
         return *this;
     }
 
-    T* operator+(size_t offset) noexcept {
+    constexpr T* operator+(size_t offset) noexcept {
         // Разрешается получать адрес ячейки памяти, следующей за последним элементом массива
         assert(offset <= capacity_);
         return buffer_ + offset;
     }
 
-    const T* operator+(size_t offset) const noexcept {
+    constexpr const T* operator+(size_t offset) const noexcept {
         return const_cast<RawMemory&>(*this) + offset;
     }
 
-    const T& operator[](size_t index) const noexcept {
+    constexpr const T& operator[](size_t index) const noexcept {
         return const_cast<RawMemory&>(*this)[index];
     }
 
-    T& operator[](size_t index) noexcept {
+    constexpr T& operator[](size_t index) noexcept {
         assert(index < capacity_);
         return buffer_[index];
     }
 
-    void Swap(RawMemory& other) noexcept {
+    constexpr void Swap(RawMemory& other) noexcept {
+        if constexpr (std::is_swappable_v<Allocator>) {
+            using std::swap;
+            swap(alloc_, other.alloc_);
+        }
         std::swap(buffer_, other.buffer_);
         std::swap(capacity_, other.capacity_);
     }
 
-    const T* GetAddress() const noexcept {
+    constexpr const T* GetAddress() const noexcept {
         return buffer_;
     }
 
-    T* GetAddress() noexcept {
+    constexpr T* GetAddress() noexcept {
         return buffer_;
     }
 
-    size_t Capacity() const {
+    constexpr size_t Capacity() const {
         return capacity_;
     }
 
+    constexpr const Allocator& GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+    constexpr Allocator& GetAllocator() noexcept {
+        return alloc_;
+    }
+
+    // Меняет вместимость буфера на new_capacity при помощи Allocator::reallocate.
+    // Первые min(Capacity(), new_capacity) ячеек переносятся побайтово
+    void Reallocate(size_t new_capacity) requires allocator_supports_reallocate_v<Allocator> {
+        if (buffer_ == nullptr || new_capacity == 0) {
+            RawMemory new_memory(new_capacity, alloc_);
+            Swap(new_memory);
+            return;
+        }
+        buffer_ = alloc_.reallocate(buffer_, capacity_, new_capacity);
+        RecordDeallocation<T>(capacity_);
+        RecordAllocation<T>(new_capacity);
+        capacity_ = new_capacity;
+    }
+
 private:
-    // Выделяет сырую память под n элементов и возвращает указатель на неё
-    static T* Allocate(size_t n) {
-        return n != 0 ? static_cast<T*>(operator new(n * sizeof(T))) : nullptr;
+    // Выделяет сырую память под n элементов и возвращает указатель на неё.
+    // При вычислении на этапе компиляции память выделяется std::allocator: только он там
+    // доступен, а такая память всё равно не переживает само вычисление
+    constexpr T* Allocate(size_t n) {
+        if (n == 0) {
+            return nullptr;
+        }
+        if (std::is_constant_evaluated()) {
+            return std::allocator<T>().allocate(n);
+        }
+        T* buf = AllocTraits::allocate(alloc_, n);
+        RecordAllocation<T>(n);
+        return buf;
     }
 
-    // Освобождает сырую память, выделенную ранее по адресу buf при помощи Allocate
-    static void Deallocate(T* buf) noexcept {
-        operator delete(buf);
+    // Освобождает сырую память под n элементов, выделенную ранее по адресу buf при помощи Allocate
+    constexpr void Deallocate(T* buf, size_t n) noexcept {
+        if (buf == nullptr) {
+            return;
+        }
+        if (std::is_constant_evaluated()) {
+            std::allocator<T>().deallocate(buf, n);
+        }
+        else {
+            AllocTraits::deallocate(alloc_, buf, n);
+            RecordDeallocation<T>(n);
+        }
     }
 
+    [[no_unique_address]] Allocator alloc_;
     T* buffer_ = nullptr;
     size_t capacity_ = 0;
 };
 
+// Политика роста вычисляет вместимость, до которой увеличивается заполненный вектор.
+// NextCapacity получает текущую вместимость и необходимый минимум и возвращает не меньше него.
+// Политике, которой важен аллокатор, Vector передаёт его третьим аргументом, если у неё
+// есть перегрузка NextCapacity<T>(capacity, required, alloc)
+
+// Удваивает вместимость: минимум перевыделений ценой до 50% неиспользуемой памяти
+struct DoublingGrowth {
+    template <typename T>
+    static constexpr size_t NextCapacity(size_t capacity, size_t required) noexcept {
+        return std::max(capacity == 0 ? 1 : capacity * 2, required);
+    }
+};
+
+// Увеличивает вместимость в полтора раза: меньше избыточной памяти на больших векторах
+struct OneAndHalfGrowth {
+    template <typename T>
+    static constexpr size_t NextCapacity(size_t capacity, size_t required) noexcept {
+        return std::max(capacity + capacity / 2, std::max<size_t>(required, 1));
+    }
+};
+
+// Первое выделение сразу занимает не меньше MinBytes байт (по умолчанию одну кэш-линию),
+// что избавляет небольшие векторы от цепочки перевыделений 1, 2, 4, 8
+template <typename Base = DoublingGrowth, size_t MinBytes = 64>
+struct CacheLineGrowth {
+    template <typename T>
+    static constexpr size_t NextCapacity(size_t capacity, size_t required) noexcept {
+        constexpr size_t min_capacity = std::max<size_t>(MinBytes / sizeof(T), 1);
+        return std::max(Base::template NextCapacity<T>(capacity, required), min_capacity);
+    }
+};
+
+// Округляет размер выделения вверх до размерного класса аллокатора, чтобы память,
+// которую аллокатор всё равно отдаст целиком, досталась элементам вектора. Классы сообщает
+// сам аллокатор через good_size (allocator_has_good_size_v), а для остальных аллокаторов
+// они берутся из таблицы RoundUpToSizeClass, рассчитанной на malloc вроде jemalloc
+template <typename Base = DoublingGrowth>
+struct SizeClassGrowth {
+    template <typename T>
+    static constexpr size_t NextCapacity(size_t capacity, size_t required) noexcept {
+        size_t bytes = RoundUpToSizeClass(Base::template NextCapacity<T>(capacity, required) * sizeof(T));
+        return bytes / sizeof(T);
+    }
+
+    template <typename T, typename Allocator>
+    static constexpr size_t NextCapacity(size_t capacity, size_t required, const Allocator& alloc) noexcept {
+        if constexpr (allocator_has_good_size_v<Allocator>) {
+            return alloc.good_size(Base::template NextCapacity<T>(capacity, required));
+        }
+        else {
+            return NextCapacity<T>(capacity, required);
+        }
+    }
+
+    // Классы как у jemalloc и tcmalloc: шаг 16 байт для мелких блоков
+    // и четыре класса на каждую степень двойки для остальных
+    static constexpr size_t RoundUpToSizeClass(size_t bytes) noexcept {
+        constexpr size_t min_step = 16;
+        if (bytes <= min_step) {
+            return min_step;
+        }
+        size_t step = std::max(std::bit_floor(bytes - 1) / 4, min_step);
+        return (bytes + step - 1) / step * step;
+    }
+};
+
+// Алгоритмы std::uninitialized_* до C++26 не constexpr, поэтому при вычислении на этапе компиляции
+// вспомогательные функции ниже создают элементы поштучно через std::construct_at. Исключение
+// там само по себе прерывает вычисление, так что откат созданных элементов не нужен
+
+// Перемещает count элементов в неинициализированную память to, если перемещение не бросает
+// исключений либо тип не копируется; иначе копирует их, сохраняя исходные элементы нетронутыми
 template <typename T>
+constexpr void InitializeWithCopyMoveUninitializedN(T* from, size_t count, T* to) {
+    if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+        if (std::is_constant_evaluated()) {
+            for (size_t i = 0; i < count; ++i) {
+                std::construct_at(to + i, std::move(from[i]));
+            }
+        }
+        else {
+            std::uninitialized_move_n(from, count, to);
+        }
+        RecordMoves<T>(count);
+    }
+    else {
+        if (std::is_constant_evaluated()) {
+            for (size_t i = 0; i < count; ++i) {
+                std::construct_at(to + i, std::as_const(from[i]));
+            }
+        }
+        else {
+            std::uninitialized_copy_n(from, count, to);
+        }
+        RecordCopies<T>(count);
+    }
+}
+
+// Копирует count элементов в неинициализированную память to. Тривиально копируемые
+// элементы копируются memcpy, большие диапазоны делятся между потоками (см. vector_parallel.h)
+template <typename T>
+constexpr void CopyUninitializedN(const T* from, size_t count, T* to) {
+    if (std::is_constant_evaluated()) {
+        for (size_t i = 0; i < count; ++i) {
+            std::construct_at(to + i, from[i]);
+        }
+        return;
+    }
+    ConstructInChunks(to, count, [from, to](T* chunk, size_t n) {
+        const T* source = from + (chunk - to);
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            if (n != 0) {
+                std::memcpy(static_cast<void*>(chunk), static_cast<const void*>(source), n * sizeof(T));
+            }
+        }
+        else {
+            std::uninitialized_copy_n(source, n, chunk);
+        }
+    });
+}
+
+// Создаёт count элементов инициализацией значением, деля большие диапазоны между потоками
+template <typename T>
+constexpr void ValueConstructUninitializedN(T* to, size_t count) {
+    if (std::is_constant_evaluated()) {
+        for (size_t i = 0; i < count; ++i) {
+            std::construct_at(to + i);
+        }
+        return;
+    }
+    ConstructInChunks(to, count, [](T* chunk, size_t n) {
+        std::uninitialized_value_construct_n(chunk, n);
+    });
+}
+
+// Создаёт count элементов инициализацией по умолчанию; для тривиальных типов ничего не делает.
+// На этапе компиляции читать неинициализированные значения нельзя, и элементы инициализируются значением
+template <typename T>
+constexpr void DefaultConstructUninitializedN(T* to, size_t count) {
+    if (std::is_constant_evaluated()) {
+        ValueConstructUninitializedN(to, count);
+        return;
+    }
+    if constexpr (!std::is_trivially_default_constructible_v<T>) {
+        ConstructInChunks(to, count, [](T* chunk, size_t n) {
+            std::uninitialized_default_construct_n(chunk, n);
+        });
+    }
+}
+
+// Переносит count элементов в неинициализированную память to. Исходные элементы
+// после вызова считаются уничтоженными
+template <typename T>
+constexpr void RelocateUninitializedN(T* from, size_t count, T* to) {
+    // memcpy недоступен на этапе компиляции, там элементы переносятся конструктором
+    if constexpr (is_trivially_relocatable_v<T>) {
+        if (!std::is_constant_evaluated()) {
+            if (count != 0) {
+                std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), count * sizeof(T));
+                RecordRelocations<T>(count);
+            }
+            return;
+        }
+    }
+    InitializeWithCopyMoveUninitializedN(from, count, to);
+    std::destroy_n(from, count);
+}
+
+// Перегрузки ниже принимают аллокатор буфера. Если он настраивает создание элементов
+// (allocator_customizes_construct_v), элементы создаются и уничтожаются по одному через
+// std::allocator_traits, иначе вызываются перегрузки без аллокатора с их быстрыми путями
+
+// Уничтожает count элементов, начиная с first
+template <typename Allocator, typename T>
+constexpr void DestroyN(Allocator& alloc, T* first, size_t count) noexcept {
+    if constexpr (allocator_customizes_construct_v<Allocator>) {
+        for (size_t i = 0; i < count; ++i) {
+            std::allocator_traits<Allocator>::destroy(alloc, first + i);
+        }
+    }
+    else {
+        DestroyInChunks(first, count);
+    }
+}
+
+// Создаёт count элементов подряд с to, вызывая construct_one для каждой ячейки.
+// При исключении уничтожает уже созданные элементы
+template <typename Allocator, typename T, typename ConstructOne>
+constexpr void ConstructEachN(Allocator& alloc, T* to, size_t count, ConstructOne construct_one) {
+    size_t constructed = 0;
+    try {
+        for (; constructed < count; ++constructed) {
+            construct_one(to + constructed);
+        }
+    }
+    catch (...) {
+        DestroyN(alloc, to, constructed);
+        throw;
+    }
+}
+
+template <typename Allocator, typename T>
+constexpr void InitializeWithCopyMoveUninitializedN(Allocator& alloc, T* from, size_t count, T* to) {
+    using AllocTraits = std::allocator_traits<Allocator>;
+    if constexpr (!allocator_customizes_construct_v<Allocator>) {
+        InitializeWithCopyMoveUninitializedN(from, count, to);
+    }
+    else if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+        ConstructEachN(alloc, to, count, [&alloc, &from](T* p) {
+            AllocTraits::construct(alloc, p, std::move(*from++));
+        });
+        RecordMoves<T>(count);
+    }
+    else {
+        ConstructEachN(alloc, to, count, [&alloc, &from](T* p) {
+            AllocTraits::construct(alloc, p, std::as_const(*from++));
+        });
+        RecordCopies<T>(count);
+    }
+}
+
+// Копирует count элементов, начиная с итератора from
+template <typename Allocator, typename InputIt, typename T>
+constexpr void CopyUninitializedN(Allocator& alloc, InputIt from, size_t count, T* to) {
+    if constexpr (allocator_customizes_construct_v<Allocator>) {
+        ConstructEachN(alloc, to, count, [&alloc, &from](T* p) {
+            std::allocator_traits<Allocator>::construct(alloc, p, *from);
+            ++from;
+        });
+    }
+    else if constexpr (std::is_convertible_v<InputIt, const T*>) {
+        CopyUninitializedN(static_cast<const T*>(from), count, to);
+    }
+    else {
+        std::uninitialized_copy_n(from, count, to);
+    }
+}
+
+// Перемещает count элементов, начиная с итератора from, даже если перемещение может бросить исключение
+template <typename Allocator, typename InputIt, typename T>
+void MoveUninitializedN(Allocator& alloc, InputIt from, size_t count, T* to) {
+    if constexpr (allocator_customizes_construct_v<Allocator>) {
+        ConstructEachN(alloc, to, count, [&alloc, &from](T* p) {
+            std::allocator_traits<Allocator>::construct(alloc, p, std::move(*from));
+            ++from;
+        });
+    }
+    else {
+        std::uninitialized_move_n(from, count, to);
+    }
+}
+
+// Создаёт count копий value
+template <typename Allocator, typename T>
+void FillUninitializedN(Allocator& alloc, T* to, size_t count, const T& value) {
+    if constexpr (allocator_customizes_construct_v<Allocator>) {
+        ConstructEachN(alloc, to, count, [&alloc, &value](T* p) {
+            std::allocator_traits<Allocator>::construct(alloc, p, value);
+        });
+    }
+    else {
+        std::uninitialized_fill_n(to, count, value);
+    }
+}
+
+template <typename Allocator, typename T>
+constexpr void ValueConstructUninitializedN(Allocator& alloc, T* to, size_t count) {
+    if constexpr (allocator_customizes_construct_v<Allocator>) {
+        ConstructEachN(alloc, to, count, [&alloc](T* p) {
+            std::allocator_traits<Allocator>::construct(alloc, p);
+        });
+    }
+    else {
+        ValueConstructUninitializedN(to, count);
+    }
+}
+
+// allocator_traits не умеет инициализировать по умолчанию, поэтому элементы аллокатора,
+// настраивающего создание, инициализируются значением
+template <typename Allocator, typename T>
+constexpr void DefaultConstructUninitializedN(Allocator& alloc, T* to, size_t count) {
+    if constexpr (allocator_customizes_construct_v<Allocator>) {
+        ValueConstructUninitializedN(alloc, to, count);
+    }
+    else {
+        DefaultConstructUninitializedN(to, count);
+    }
+}
+
+template <typename Allocator, typename T>
+constexpr void RelocateUninitializedN(Allocator& alloc, T* from, size_t count, T* to) {
+    if constexpr (allocator_customizes_construct_v<Allocator>) {
+        InitializeWithCopyMoveUninitializedN(alloc, from, count, to);
+        DestroyN(alloc, from, count);
+    }
+    else {
+        RelocateUninitializedN(from, count, to);
+    }
+}
+
+// Общие шаги вставки в середину для Vector и SmallVector
+
+// Переносит size элементов из from в новый буфер to, оставляя перед элементом index уже
+// заполненный промежуток из count элементов. При исключении уничтожает промежуток,
+// исходные элементы остаются на месте
+template <typename Allocator, typename T>
+void RelocateAroundGap(Allocator& alloc, T* from, size_t size, size_t index, size_t count, T* to) {
+    if constexpr (is_trivially_relocatable_v<T> && !allocator_customizes_construct_v<Allocator>) {
+        RelocateUninitializedN(from, index, to);
+        RelocateUninitializedN(from + index, size - index, to + index + count);
+        return;
+    }
+    try {
+        InitializeWithCopyMoveUninitializedN(alloc, from, index, to);
+    }
+    catch (...) {
+        DestroyN(alloc, to + index, count);
+        throw;
+    }
+    try {
+        InitializeWithCopyMoveUninitializedN(alloc, from + index, size - index, to + index + count);
+    }
+    catch (...) {
+        DestroyN(alloc, to, index + count);
+        throw;
+    }
+    DestroyN(alloc, from, size);
+}
+
+// Вставляет элемент, созданный из args, перед элементом index буфера first из size элементов,
+// сдвигая хвост на одну ячейку. За последним элементом должна быть свободная ячейка
+template <typename Allocator, typename T, typename... Args>
+void EmplaceShiftingTail(Allocator& alloc, T* first, size_t size, size_t index, Args&&... args) {
+    using AllocTraits = std::allocator_traits<Allocator>;
+    // Новый элемент создаётся в сыром буфере до сдвига: аргументы могут ссылаться на элементы вектора
+    alignas(T) unsigned char temp_storage[sizeof(T)];
+    AllocTraits::construct(alloc, reinterpret_cast<T*>(temp_storage), std::forward<Args>(args)...);
+    if constexpr (is_trivially_relocatable_v<T> && !allocator_customizes_construct_v<Allocator>) {
+        std::memmove(static_cast<void*>(first + index + 1), static_cast<const void*>(first + index),
+                     (size - index) * sizeof(T));
+        std::memcpy(static_cast<void*>(first + index), temp_storage, sizeof(T));
+        return;
+    }
+    T* temp_obj = std::launder(reinterpret_cast<T*>(temp_storage));
+    T* last = first + size;
+    try {
+        AllocTraits::construct(alloc, last, std::move(*(last - 1)));
+        try {
+            std::move_backward(first + index, last - 1, last);
+            first[index] = std::move(*temp_obj);
+        }
+        catch (...) {
+            AllocTraits::destroy(alloc, last);
+            throw;
+        }
+    }
+    catch (...) {
+        AllocTraits::destroy(alloc, temp_obj);
+        throw;
+    }
+    AllocTraits::destroy(alloc, temp_obj);
+}
+
+// Тег конструктора, создающего элементы инициализацией по умолчанию: тривиальные типы
+// остаются неинициализированными, и буфер не обнуляется перед тем, как его перезапишут
+struct ForOverwriteT {
+    explicit ForOverwriteT() = default;
+};
+
+inline constexpr ForOverwriteT for_overwrite{};
+
+template <typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = DoublingGrowth>
 class Vector {
+    using AllocTraits = std::allocator_traits<Allocator>;
+
 public:
+    using allocator_type = Allocator;
 
     Vector() = default;
 
-    explicit Vector(size_t size)
-        : data_(size)
+    constexpr explicit Vector(const Allocator& alloc) noexcept
+        : data_(alloc)
+    {
+    }
+
+    constexpr explicit Vector(size_t size, const Allocator& alloc = Allocator())
+        : data_(size, alloc)
+        , size_(size)  //
+    {
+        ValueConstructUninitializedN(data_.GetAllocator(), begin(), size);
+    }
+
+    constexpr Vector(size_t size, ForOverwriteT, const Allocator& alloc = Allocator())
+        : data_(size, alloc)
         , size_(size)  //
     {
-        std::uninitialized_value_construct_n(begin(), size);
+        DefaultConstructUninitializedN(data_.GetAllocator(), begin(), size);
     }
 
-    Vector(const Vector& other)
-        : data_(other.size_)
+    constexpr Vector(const Vector& other)
+        : Vector(other, AllocTraits::select_on_container_copy_construction(other.GetAllocator()))
+    {
+    }
+
+    constexpr Vector(const Vector& other, const Allocator& alloc)
+        : data_(other.size_, alloc)
         , size_(other.size_)  //
     {
-        std::uninitialized_copy_n(other.begin(), other.size_, begin());
+        CopyUninitializedN(data_.GetAllocator(), other.begin(), other.size_, begin());
     }
 
-    Vector(Vector&& other) noexcept
+    constexpr Vector(Vector&& other) noexcept
         : data_(std::move(other.data_))
         , size_(std::exchange(other.size_, 0))
     {
     }
 
-    ~Vector() {
-        std::destroy_n(begin(), size_);
+    // Буфер other можно забрать, только если alloc способен его освободить,
+    // иначе элементы перемещаются поштучно в память, выделенную alloc
+    constexpr Vector(Vector&& other, const Allocator& alloc)
+        : data_(alloc)
+    {
+        if (alloc == other.GetAllocator()) {
+            data_ = std::move(other.data_);
+            size_ = std::exchange(other.size_, 0);
+        }
+        else {
+            RawMemory<T, Allocator> new_data(other.size_, alloc);
+            MoveUninitializedN(new_data.GetAllocator(), other.begin(), other.size_, new_data.GetAddress());
+            data_.Swap(new_data);
+            size_ = other.size_;
+        }
+    }
+
+    constexpr ~Vector() {
+        DestroyN(data_.GetAllocator(), begin(), size_);
     }
 
     using iterator = T*;
     using const_iterator = const T*;
 
-    iterator begin() noexcept {
+    constexpr iterator begin() noexcept {
         return data_.GetAddress();
     }
 
-    iterator end() noexcept {
+    constexpr iterator end() noexcept {
         return data_.GetAddress() + size_;
     }
 
-    const_iterator begin() const noexcept {
+    constexpr const_iterator begin() const noexcept {
         return cbegin();
     }
 
-    const_iterator end() const noexcept {
+    constexpr const_iterator end() const noexcept {
         return cend();
     }
 
-    const_iterator cbegin() const noexcept {
+    constexpr const_iterator cbegin() const noexcept {
         return data_.GetAddress();
     }
 
-    const_iterator cend() const noexcept {
+    constexpr const_iterator cend() const noexcept {
         return data_.GetAddress() + size_;
     }
 
     Vector& operator=(const Vector& rhs) {
         if (this != &rhs) {
+            if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+                if (GetAllocator() != rhs.GetAllocator()) {
+                    // Текущий буфер может освободить только текущий аллокатор, поэтому он уходит
+                    // во временный объект вместе с ним. Swap здесь не подходит: без
+                    // propagate_on_container_swap он требует равных аллокаторов
+                    Vector rhs_copy(rhs, rhs.GetAllocator());
+                    data_.Swap(rhs_copy.data_);
+                    std::swap(size_, rhs_copy.size_);
+                    return *this;
+                }
+            }
             if (rhs.size_ > data_.Capacity()) {
-                Vector rhs_copy(rhs);
+                Vector rhs_copy(rhs, GetAllocator());
                 Swap(rhs_copy);
             }
+            else if constexpr (std::is_trivially_copyable_v<T> && kConstructsDirectly) {
+                // Элементы не нужно уничтожать, а копирование в живые и в свободные ячейки одинаково
+                if (rhs.size_ != 0) {
+                    std::memcpy(static_cast<void*>(begin()), static_cast<const void*>(rhs.begin()), rhs.size_ * sizeof(T));
+                }
+                size_ = rhs.size_;
+            }
             else {
                 size_t copy_size = std::min(rhs.size_, size_);
                 std::copy_n(rhs.begin(), copy_size, begin());
                 if (rhs.size_ < size_) {
-                    std::destroy_n(begin() + rhs.size_, size_ - rhs.size_);
+                    DestroyN(data_.GetAllocator(), begin() + rhs.size_, size_ - rhs.size_);
                 }
                 else {
-                    std::uninitialized_copy_n(rhs.begin() + size_, rhs.size_ - size_, end());
+                    CopyUninitializedN(data_.GetAllocator(), rhs.begin() + size_, rhs.size_ - size_, end());
                 }
                 size_ = rhs.size_;
             }
@@ -163,54 +715,155 @@ public:
         return *this;
     }
 
-    Vector& operator=(Vector&& rhs) noexcept {
+    constexpr Vector& operator=(Vector&& rhs) noexcept(AllocTraits::propagate_on_container_move_assignment::value
+                                             || AllocTraits::is_always_equal::value) {
         if (this != &rhs) {
+            if constexpr (!AllocTraits::propagate_on_container_move_assignment::value
+                          && !AllocTraits::is_always_equal::value) {
+                if (GetAllocator() != rhs.GetAllocator()) {
+                    Vector rhs_moved(std::move(rhs), GetAllocator());
+                    Swap(rhs_moved);
+                    return *this;
+                }
+            }
+            DestroyN(data_.GetAllocator(), begin(), size_);
             data_ = std::move(rhs.data_);
             size_  = std::exchange(rhs.size_, 0);
         }
         return *this;
     }
 
-    void Reserve(size_t new_capacity) {
+    constexpr void Reserve(size_t new_capacity) {
         if (new_capacity <= data_.Capacity()) {
             return;
         }
-        RawMemory<T> new_data(new_capacity);
-        InitializeWithCopyMoveUninitializedN(begin(), size_,new_data.GetAddress());
-        std::destroy_n(begin(), size_);
+        if constexpr (kReallocatesInPlace) {
+            if (!std::is_constant_evaluated()) {
+                data_.Reallocate(new_capacity);
+                return;
+            }
+        }
+        RawMemory<T, Allocator> new_data(new_capacity, data_.GetAllocator());
+        RelocateUninitializedN(data_.GetAllocator(), begin(), size_, new_data.GetAddress());
         data_.Swap(new_data);
     }
 
-    void Resize(size_t new_size){
+    constexpr void Resize(size_t new_size){
         if (new_size < size_) {
-            std::destroy_n(begin() + new_size, size_ - new_size);
+            DestroyN(data_.GetAllocator(), begin() + new_size, size_ - new_size);
         }
         else if (new_size > size_) {
             Reserve(new_size);
-            std::uninitialized_value_construct_n(end(), new_size - size_);
+            ValueConstructUninitializedN(data_.GetAllocator(), end(), new_size - size_);
         }
         size_ = new_size;
     }
 
-    void PushBack(const T& value) {
+    // Как Resize, но новые элементы создаются копированием value; подходит и для типов
+    // без конструктора по умолчанию
+    void Resize(size_t new_size, const T& value) {
+        if (new_size < size_) {
+            DestroyN(data_.GetAllocator(), begin() + new_size, size_ - new_size);
+            size_ = new_size;
+        }
+        else if (new_size > size_) {
+            Insert(end(), new_size - size_, value);
+        }
+    }
+
+    // Как Resize, но новые элементы инициализируются по умолчанию, а не значением,
+    // поэтому тривиальные типы не обнуляются
+    constexpr void ResizeForOverwrite(size_t new_size) {
+        if (new_size < size_) {
+            DestroyN(data_.GetAllocator(), begin() + new_size, size_ - new_size);
+        }
+        else if (new_size > size_) {
+            Reserve(new_size);
+            DefaultConstructUninitializedN(data_.GetAllocator(), end(), new_size - size_);
+        }
+        size_ = new_size;
+    }
+
+    // Гарантирует место как минимум под count элементов после конца вектора и возвращает весь
+    // неиспользуемый остаток буфера для прямой записи (например, из сокета или декодера).
+    // Записанные элементы становятся частью вектора только после вызова CommitSize.
+    // Элементы нетривиальных типов перед публикацией нужно создать через
+    // std::allocator_traits<Allocator>::construct с аллокатором вектора
+    std::span<T> GrowUninitialized(size_t count) {
+        if (size_ + count > Capacity()) {
+            Reserve(NextCapacity(size_ + count));
+        }
+        return std::span<T>(end(), Capacity() - size_);
+    }
+
+    // Добавляет к размеру вектора count элементов, записанных в буфер, полученный от GrowUninitialized
+    void CommitSize(size_t count) noexcept {
+        assert(count <= Capacity() - size_);
+        size_ += count;
+    }
+
+    // Уничтожает все элементы, сохраняя буфер для повторного использования
+    constexpr void Clear() noexcept {
+        DestroyN(data_.GetAllocator(), begin(), size_);
+        size_ = 0;
+    }
+
+    // Уменьшает вместимость до размера вектора, возвращая лишнюю память аллокатору
+    void ShrinkToFit() {
+        if (Capacity() == size_) {
+            return;
+        }
+        if constexpr (kReallocatesInPlace) {
+            data_.Reallocate(size_);
+            return;
+        }
+        RawMemory<T, Allocator> new_data(size_, data_.GetAllocator());
+        RelocateUninitializedN(data_.GetAllocator(), begin(), size_, new_data.GetAddress());
+        data_.Swap(new_data);
+    }
+
+    // Вызывает ShrinkToFit, если вместимость превышает размер больше чем в max_ratio раз,
+    // например после всплеска нагрузки. Возвращает true, если буфер был уменьшен
+    bool ShrinkIfOversized(double max_ratio = 2.0) {
+        assert(max_ratio >= 1.0);
+        if (static_cast<double>(Capacity()) <= static_cast<double>(size_) * max_ratio) {
+            return false;
+        }
+        ShrinkToFit();
+        return true;
+    }
+
+    constexpr void PushBack(const T& value) {
         (void)EmplaceBack(value);
     }
 
-    void PushBack(T&& value) {
+    constexpr void PushBack(T&& value) {
         (void)EmplaceBack(std::move(value));
     }
 
     template <typename... Args>
-    T& EmplaceBack(Args&&... args) {
+    constexpr T& EmplaceBack(Args&&... args) {
+        if constexpr (kReallocatesInPlace) {
+            if (size_ == Capacity() && !std::is_constant_evaluated()) {
+                ReallocateAndEmplace(size_, std::forward<Args>(args)...);
+                ++size_;
+                return *(end() - 1);
+            }
+        }
         if (size_ == Capacity()) {
-            RawMemory<T> new_data(size_ == 0 ? 1 : size_ * 2);
-            new (new_data.GetAddress() + size_) T(std::forward<Args>(args)...);
-            InitializeWithCopyMoveUninitializedN(begin(), size_, new_data.GetAddress());
-            std::destroy_n(begin(), size_);
+            RawMemory<T, Allocator> new_data(NextCapacity(size_ + 1), data_.GetAllocator());
+            ConstructAt(new_data.GetAddress() + size_, std::forward<Args>(args)...);
+            try {
+                RelocateUninitializedN(data_.GetAllocator(), begin(), size_, new_data.GetAddress());
+            }
+            catch (...) {
+                DestroyAt(new_data.GetAddress() + size_);
+                throw;
+            }
             data_.Swap(new_data);
         }
         else {
-            new (data_ + size_) T(std::forward<Args>(args)...);
+            ConstructAt(data_ + size_, std::forward<Args>(args)...);
         }
         ++size_;
         return  *(end() - 1);
@@ -227,19 +880,122 @@ public:
             EmplaceFilledVector(iter, std::forward<Args>(args)...);
         }
         else {
-            EmplaceUnFilledVector(iter, std::forward<Args>(args)...);
+            EmplaceShiftingTail(data_.GetAllocator(), begin(), size_, iter, std::forward<Args>(args)...);
         }
         ++size_;
         return begin()+iter;
     }
 
-    iterator Erase(const_iterator pos) noexcept(std::is_nothrow_move_assignable_v<T>) {
+    iterator Erase(const_iterator pos) noexcept(kRelocatesBitwise || std::is_nothrow_move_assignable_v<T>) {
         auto iter = pos - begin();
+        if constexpr (kRelocatesBitwise) {
+            DestroyAt(begin() + iter);
+            std::memmove(static_cast<void*>(begin() + iter), static_cast<const void*>(begin() + iter + 1),
+                         (size_ - iter - 1) * sizeof(T));
+            --size_;
+            return begin() + iter;
+        }
         std::move(begin() + iter + 1, end(), begin() + iter);
         PopBack();
         return begin() + iter;
     }
 
+    iterator Erase(const_iterator first, const_iterator last) noexcept(kRelocatesBitwise
+                                                                        || std::is_nothrow_move_assignable_v<T>) {
+        assert(begin() <= first && first <= last && last <= end());
+        const size_t index = first - begin();
+        const size_t count = last - first;
+        if (count == 0) {
+            return begin() + index;
+        }
+        if constexpr (kRelocatesBitwise) {
+            DestroyN(data_.GetAllocator(), begin() + index, count);
+            std::memmove(static_cast<void*>(begin() + index), static_cast<const void*>(begin() + index + count),
+                         (size_ - index - count) * sizeof(T));
+        }
+        else {
+            std::move(begin() + index + count, end(), begin() + index);
+            DestroyN(data_.GetAllocator(), end() - count, count);
+        }
+        size_ -= count;
+        return begin() + index;
+    }
+
+    // Удаляет за один проход все элементы, для которых pred вернул true, сохраняя порядок остальных.
+    // Возвращает количество удалённых элементов
+    template <typename Predicate>
+    size_t EraseIf(Predicate pred) {
+        if constexpr (kRelocatesBitwise) {
+            iterator kept_end = begin();
+            iterator it = begin();
+            try {
+                for (; it != end(); ++it) {
+                    if (pred(*it)) {
+                        DestroyAt(it);
+                    }
+                    else {
+                        if (kept_end != it) {
+                            std::memcpy(static_cast<void*>(kept_end), static_cast<const void*>(it), sizeof(T));
+                        }
+                        ++kept_end;
+                    }
+                }
+            }
+            catch (...) {
+                // Непросмотренные элементы придвигаются к оставленным, чтобы не осталось дыр
+                std::memmove(static_cast<void*>(kept_end), static_cast<const void*>(it), (end() - it) * sizeof(T));
+                size_ = (kept_end - begin()) + (end() - it);
+                throw;
+            }
+            const size_t removed = end() - kept_end;
+            size_ -= removed;
+            return removed;
+        }
+        else {
+            iterator kept_end = std::remove_if(begin(), end(), pred);
+            const size_t removed = end() - kept_end;
+            DestroyN(data_.GetAllocator(), kept_end, removed);
+            size_ -= removed;
+            return removed;
+        }
+    }
+
+    // Удаляет элементы с индексами из sorted_indices (строго возрастающими) одним проходом:
+    // каждый оставшийся элемент сдвигается не больше одного раза. Возвращает количество удалённых
+    template <typename IndexRange>
+    size_t EraseIndices(const IndexRange& sorted_indices) noexcept(kRelocatesBitwise
+                                                                   || std::is_nothrow_move_assignable_v<T>) {
+        auto it = std::begin(sorted_indices);
+        const auto last = std::end(sorted_indices);
+        if (it == last) {
+            return 0;
+        }
+        size_t kept_end = static_cast<size_t>(*it);
+        size_t removed = 0;
+        while (it != last) {
+            const size_t index = static_cast<size_t>(*it);
+            ++it;
+            const size_t next = it == last ? size_ : static_cast<size_t>(*it);
+            assert(index < next && next <= size_);
+            const size_t kept = next - index - 1;
+            if constexpr (kRelocatesBitwise) {
+                DestroyAt(begin() + index);
+                std::memmove(static_cast<void*>(begin() + kept_end), static_cast<const void*>(begin() + index + 1),
+                             kept * sizeof(T));
+            }
+            else {
+                std::move(begin() + index + 1, begin() + next, begin() + kept_end);
+            }
+            kept_end += kept;
+            ++removed;
+        }
+        if constexpr (!kRelocatesBitwise) {
+            DestroyN(data_.GetAllocator(), begin() + kept_end, removed);
+        }
+        size_ -= removed;
+        return removed;
+    }
+
     iterator Insert(const_iterator pos, const T& value) {
         return Emplace(pos, value);
     }
@@ -248,75 +1004,205 @@ public:
         return Emplace(pos, std::move(value));
     }
 
-    void PopBack() noexcept {
+    iterator Insert(const_iterator pos, size_t count, const T& value) {
+        if (std::less_equal<const T*>()(begin(), &value) && std::less<const T*>()(&value, end())) {
+            // value лежит внутри вектора и может сдвинуться вместе с хвостом
+            T value_copy(value);
+            return Insert(pos, count, value_copy);
+        }
+        return InsertConstructed(pos, count, [this, &value](iterator to, size_t n) {
+            FillUninitializedN(data_.GetAllocator(), to, n, value);
+        });
+    }
+
+    // Диапазон [first, last) не должен указывать на элементы самого вектора
+    template <std::input_iterator InputIt>
+    iterator Insert(const_iterator pos, InputIt first, InputIt last) {
+        using Category = typename std::iterator_traits<InputIt>::iterator_category;
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, Category>) {
+            return InsertConstructed(pos, static_cast<size_t>(std::distance(first, last)), [this, first](iterator to, size_t n) {
+                CopyUninitializedN(data_.GetAllocator(), first, n, to);
+            });
+        }
+        else {
+            // Длина однопроходного диапазона заранее неизвестна, поэтому он сначала собирается во временный вектор
+            Vector values(GetAllocator());
+            for (; first != last; ++first) {
+                values.EmplaceBack(*first);
+            }
+            return InsertConstructed(pos, values.Size(), [this, &values](iterator to, size_t n) {
+                MoveUninitializedN(data_.GetAllocator(), values.begin(), n, to);
+            });
+        }
+    }
+
+    iterator Insert(const_iterator pos, std::initializer_list<T> values) {
+        return Insert(pos, values.begin(), values.end());
+    }
+
+    constexpr void PopBack() noexcept {
         assert(size_ != 0);
         --size_;
-        std::destroy_at(end());
+        DestroyAt(end());
     }
 
-    void Swap(Vector& other) noexcept {
+    constexpr void Swap(Vector& other) noexcept {
+        // Без propagate_on_container_swap обмен допустим только между равными аллокаторами
+        assert(AllocTraits::propagate_on_container_swap::value || GetAllocator() == other.GetAllocator());
         data_.Swap(other.data_);
         std::swap(size_, other.size_);
     }
 
-    size_t Size() const noexcept {
+    constexpr size_t Size() const noexcept {
         return size_;
     }
 
-    size_t Capacity() const noexcept {
+    constexpr size_t Capacity() const noexcept {
         return data_.Capacity();
     }
 
-    const T& operator[](size_t index) const noexcept {
+    constexpr Allocator GetAllocator() const noexcept {
+        return data_.GetAllocator();
+    }
+
+    constexpr const T& operator[](size_t index) const noexcept {
         return const_cast<Vector&>(*this)[index];   
     }
 
-    T& operator[](size_t index) noexcept {
+    constexpr T& operator[](size_t index) noexcept {
         assert(index < size_);
         return data_[index];
     }
 
 private:
+    // Аллокатор не вмешивается в создание элементов, и их можно создавать и переносить напрямую
+    static constexpr bool kConstructsDirectly = !allocator_customizes_construct_v<Allocator>;
+    static constexpr bool kRelocatesBitwise = is_trivially_relocatable_v<T> && kConstructsDirectly;
+    // Тривиально перемещаемые элементы растут через Allocator::reallocate без промежуточного буфера
+    static constexpr bool kReallocatesInPlace = kRelocatesBitwise && allocator_supports_reallocate_v<Allocator>;
+
+    template <typename... Args>
+    constexpr void ConstructAt(T* p, Args&&... args) {
+        AllocTraits::construct(data_.GetAllocator(), p, std::forward<Args>(args)...);
+    }
+
+    constexpr void DestroyAt(T* p) noexcept {
+        AllocTraits::destroy(data_.GetAllocator(), p);
+    }
+
+    // Вызывается ровно тогда, когда вставке не хватает вместимости, поэтому заодно учитывает рост
+    constexpr size_t NextCapacity(size_t required) const noexcept {
+        RecordGrowth<T>();
+        if constexpr (requires { GrowthPolicy::template NextCapacity<T>(size_t{}, size_t{}, data_.GetAllocator()); }) {
+            // На этапе компиляции память выделяет std::allocator, и классы аллокатора вектора не важны
+            if (!std::is_constant_evaluated()) {
+                return GrowthPolicy::template NextCapacity<T>(Capacity(), required, data_.GetAllocator());
+            }
+        }
+        return GrowthPolicy::template NextCapacity<T>(Capacity(), required);
+    }
+
     template <typename... Args>
     void EmplaceFilledVector(size_t iter, Args&&... args) {
-        RawMemory<T> new_data(size_ == 0 ? 1 : size_ * 2);
-        new (new_data.GetAddress() + iter) T(std::forward<Args>(args)...);
-        try {
-            InitializeWithCopyMoveUninitializedN(begin(), iter, new_data.GetAddress());
+        if constexpr (kReallocatesInPlace) {
+            ReallocateAndEmplace(iter, std::forward<Args>(args)...);
+            return;
         }
-        catch (...) {
-            std::destroy_at(new_data.GetAddress() + iter);
-            throw;
+        RawMemory<T, Allocator> new_data(NextCapacity(size_ + 1), data_.GetAllocator());
+        ConstructAt(new_data.GetAddress() + iter, std::forward<Args>(args)...);
+        RelocateAroundGap(data_.GetAllocator(), begin(), size_, iter, 1, new_data.GetAddress());
+        data_.Swap(new_data);
+    }
+
+    // Вставляет count элементов перед pos, выделяя память не более одного раза и сдвигая хвост
+    // единожды. construct(to, n) создаёт n элементов в неинициализированной памяти to и при
+    // исключении сам уничтожает уже созданные
+    template <typename Construct>
+    iterator InsertConstructed(const_iterator pos, size_t count, Construct construct) {
+        assert(begin() <= pos && pos <= end());
+        const size_t index = pos - begin();
+        if (count == 0) {
+            return begin() + index;
         }
-        try {
-            InitializeWithCopyMoveUninitializedN(begin() + iter, size_ - iter, new_data.GetAddress() + iter + 1);
+        if (size_ + count > Capacity()) {
+            const size_t new_capacity = NextCapacity(size_ + count);
+            if constexpr (kReallocatesInPlace) {
+                data_.Reallocate(new_capacity);
+            }
+            else {
+                RawMemory<T, Allocator> new_data(new_capacity, data_.GetAllocator());
+                construct(new_data.GetAddress() + index, count);
+                RelocateAroundGap(data_.GetAllocator(), begin(), size_, index, count, new_data.GetAddress());
+                data_.Swap(new_data);
+                size_ += count;
+                return begin() + index;
+            }
         }
-        catch (...) {
-            std::destroy_n(new_data.GetAddress(), iter + 1);
-            throw;
+        if constexpr (kRelocatesBitwise) {
+            std::memmove(static_cast<void*>(begin() + index + count), static_cast<const void*>(begin() + index),
+                         (size_ - index) * sizeof(T));
+            try {
+                construct(begin() + index, count);
+            }
+            catch (...) {
+                std::memmove(static_cast<void*>(begin() + index), static_cast<const void*>(begin() + index + count),
+                             (size_ - index) * sizeof(T));
+                throw;
+            }
         }
-        std::destroy_n(begin(), size_);
-        data_.Swap(new_data);
+        else {
+            construct(end(), count);
+            try {
+                std::rotate(begin() + index, end(), end() + count);
+            }
+            catch (...) {
+                // Каждая ячейка по-прежнему хранит живой объект, но порядок уже нарушен:
+                // отбрасываем хвост, чтобы размер вектора остался прежним
+                DestroyN(data_.GetAllocator(), end(), count);
+                throw;
+            }
+        }
+        size_ += count;
+        return begin() + index;
     }
 
     template <typename... Args>
-    void EmplaceUnFilledVector(size_t iter, Args&&... args) {
-        T temp_obj = T(std::forward<Args>(args)...);
-        std::uninitialized_move_n(end() - 1, 1, end());
-        std::move_backward(begin() + iter, end() - 1, end());
-        data_[iter] = std::move(temp_obj);
-    }
-
-    void InitializeWithCopyMoveUninitializedN(iterator from, size_t count, iterator to) {
-        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-            std::uninitialized_move_n(from, count, to);
+    void ReallocateAndEmplace(size_t iter, Args&&... args) {
+        // Новый элемент создаётся до перевыделения: аргументы могут ссылаться на элементы вектора
+        alignas(T) unsigned char temp_obj[sizeof(T)];
+        ConstructAt(reinterpret_cast<T*>(temp_obj), std::forward<Args>(args)...);
+        try {
+            data_.Reallocate(NextCapacity(size_ + 1));
         }
-        else {
-            std::uninitialized_copy_n(from, count, to);
+        catch (...) {
+            DestroyAt(std::launder(reinterpret_cast<T*>(temp_obj)));
+            throw;
         }
+        std::memmove(static_cast<void*>(begin() + iter + 1), static_cast<const void*>(begin() + iter),
+                     (size_ - iter) * sizeof(T));
+        std::memcpy(static_cast<void*>(begin() + iter), temp_obj, sizeof(T));
     }
 
 
-    RawMemory<T> data_;
+    RawMemory<T, Allocator> data_;
     size_t size_ = 0;
-};
\ No newline at end of file
+};
+
+// Копирует вектор, построенный на этапе компиляции функцией make, в std::array того же размера.
+// Память, выделенная при вычислении на этапе компиляции, не может дожить до запуска программы,
+// поэтому сам Vector остаётся внутри вычисления, а наружу выходит массив:
+//     constexpr auto kSquares = ToStaticArray<[] { Vector<int> v; ...; return v; }>();
+template <auto Make>
+consteval auto ToStaticArray() {
+    using Value = std::iter_value_t<decltype(Make().begin())>;
+    constexpr size_t kSize = Make().Size();
+    std::array<Value, kSize> result{};
+    const auto vector = Make();
+    std::copy(vector.begin(), vector.end(), result.begin());
+    return result;
+}
+
+namespace pmr {
+    template <typename T>
+    using Vector = ::Vector<T, std::pmr::polymorphic_allocator<T>>;
+}
\ No newline at end of file
@@ -0,0 +1,351 @@
+#pragma once
+#include "vector.h"
+
+#include <cerrno>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <system_error>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// Двоичная сериализация Vector в файловые дескрипторы и потоки.
+// Вектор записывается как заголовок VectorIoHeader и следующие за ним элементы. Тривиально
+// копируемые элементы пишутся буфером целиком в одном writev вместе с заголовком и читаются
+// прямо в хвост вектора, без промежуточных копий. Остальные типы
+// сериализуются поэлементно через специализацию VectorElementIo. Данные хранятся в порядке
+// байт и представлении текущей платформы. Ошибки сообщаются через std::system_error
+
+struct VectorIoHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t encoding;
+    uint32_t element_size;
+    uint32_t reserved;
+    uint64_t size;
+};
+
+inline constexpr uint32_t kVectorIoMagic = 0x43455656;  // "VVEC"
+inline constexpr uint16_t kVectorIoVersion = 1;
+// Длинам из входных данных нельзя доверять, поэтому память под элементы и символы
+// выделяется порциями не больше стольких байт по мере того, как приходят сами данные
+inline constexpr size_t kVectorIoReadBatchBytes = size_t{1} << 20;
+
+enum class VectorIoEncoding : uint16_t {
+    // Элементы записаны байтами объектов, друг за другом
+    kRaw = 0,
+    // Каждый элемент записан своей специализацией VectorElementIo
+    kPerElement = 1,
+};
+
+// Точка настройки для нетривиально копируемых типов. Специализация должна предоставить
+//     template <typename Output> static void Write(Output& out, const T& value);
+//     template <typename Input> static T Read(Input& in);
+// Output и Input — любые из классов ниже; для простых полей удобны WriteTrivial и ReadTrivial
+template <typename T>
+struct VectorElementIo;
+
+template <typename T>
+concept VectorSerializable = std::is_trivially_copyable_v<T> || requires { sizeof(VectorElementIo<T>); };
+
+[[noreturn]] inline void ThrowVectorIoError(std::errc error, const char* what) {
+    throw std::system_error(std::make_error_code(error), std::string("Vector I/O: ") + what);
+}
+
+[[noreturn]] inline void ThrowVectorIoErrno(const char* call) {
+    throw std::system_error(errno, std::generic_category(), std::string("Vector I/O: ") + call);
+}
+
+// Запись в файловый дескриптор. Мелкие записи поэлементной сериализации копятся в буфере,
+// крупные и собранные через WriteGathered уходят в дескриптор напрямую.
+// Накопленное записывается только вызовом Flush
+class FdOutput {
+public:
+    explicit FdOutput(int fd) noexcept
+        : fd_(fd)
+    {
+    }
+
+    void Write(const void* data, size_t bytes) {
+        if (bytes >= kBufferBytes) {
+            Flush();
+            WriteGathered(nullptr, 0, data, bytes);
+            return;
+        }
+        if (buffered_ + bytes > kBufferBytes) {
+            Flush();
+        }
+        if (buffer_ == nullptr) {
+            buffer_ = std::make_unique<char[]>(kBufferBytes);
+        }
+        std::memcpy(buffer_.get() + buffered_, data, bytes);
+        buffered_ += bytes;
+    }
+
+    // Записывает prefix и data одним системным вызовом writev (повторяя его при частичной записи)
+    void WriteGathered(const void* prefix, size_t prefix_bytes, const void* data, size_t bytes) {
+        Flush();
+        iovec parts[] = {{const_cast<void*>(prefix), prefix_bytes}, {const_cast<void*>(data), bytes}};
+        iovec* part = parts;
+        int part_count = 2;
+        while (part_count > 0) {
+            const ssize_t written = writev(fd_, part, part_count);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                ThrowVectorIoErrno("writev");
+            }
+            size_t left = static_cast<size_t>(written);
+            while (part_count > 0 && left >= part->iov_len) {
+                left -= part->iov_len;
+                ++part;
+                --part_count;
+            }
+            if (part_count > 0) {
+                part->iov_base = static_cast<char*>(part->iov_base) + left;
+                part->iov_len -= left;
+            }
+        }
+    }
+
+    void Flush() {
+        const size_t bytes = std::exchange(buffered_, 0);
+        if (bytes != 0) {
+            WriteGathered(nullptr, 0, buffer_.get(), bytes);
+        }
+    }
+
+private:
+    static constexpr size_t kBufferBytes = size_t{64} << 10;
+
+    int fd_;
+    std::unique_ptr<char[]> buffer_;
+    size_t buffered_ = 0;
+};
+
+// Чтение из файлового дескриптора. Буфера нет: дескриптор может быть каналом, в котором
+// за вектором идут чужие данные, и читать дальше конца вектора нельзя. Поэтому поэлементное
+// чтение из дескриптора делает системный вызов на каждое поле; для него лучше подходят потоки
+class FdInput {
+public:
+    explicit FdInput(int fd) noexcept
+        : fd_(fd)
+    {
+    }
+
+    // Читает ровно bytes байт; конец данных раньше времени считается ошибкой
+    void Read(void* data, size_t bytes) {
+        char* to = static_cast<char*>(data);
+        while (bytes != 0) {
+            const ssize_t received = read(fd_, to, bytes);
+            if (received < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                ThrowVectorIoErrno("read");
+            }
+            if (received == 0) {
+                ThrowVectorIoError(std::errc::io_error, "unexpected end of input");
+            }
+            to += received;
+            bytes -= static_cast<size_t>(received);
+        }
+    }
+
+private:
+    int fd_;
+};
+
+class StreamOutput {
+public:
+    explicit StreamOutput(std::ostream& stream) noexcept
+        : stream_(stream)
+    {
+    }
+
+    void Write(const void* data, size_t bytes) {
+        stream_.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+        if (!stream_) {
+            ThrowVectorIoError(std::errc::io_error, "stream write failed");
+        }
+    }
+
+    // У потока собственный буфер, поэтому обе части просто пишутся в него по очереди
+    void WriteGathered(const void* prefix, size_t prefix_bytes, const void* data, size_t bytes) {
+        Write(prefix, prefix_bytes);
+        Write(data, bytes);
+    }
+
+    void Flush() {
+        stream_.flush();
+        if (!stream_) {
+            ThrowVectorIoError(std::errc::io_error, "stream flush failed");
+        }
+    }
+
+private:
+    std::ostream& stream_;
+};
+
+class StreamInput {
+public:
+    explicit StreamInput(std::istream& stream) noexcept
+        : stream_(stream)
+    {
+    }
+
+    void Read(void* data, size_t bytes) {
+        stream_.read(static_cast<char*>(data), static_cast<std::streamsize>(bytes));
+        if (!stream_) {
+            ThrowVectorIoError(std::errc::io_error, "unexpected end of input");
+        }
+    }
+
+private:
+    std::istream& stream_;
+};
+
+template <typename Output, typename U>
+    requires std::is_trivially_copyable_v<U>
+void WriteTrivial(Output& out, const U& value) {
+    out.Write(&value, sizeof(U));
+}
+
+template <typename U, typename Input>
+    requires std::is_trivially_copyable_v<U>
+U ReadTrivial(Input& in) {
+    U value;
+    in.Read(&value, sizeof(U));
+    return value;
+}
+
+template <typename Output, VectorSerializable T, typename Allocator, typename GrowthPolicy>
+void WriteVector(Output& out, const Vector<T, Allocator, GrowthPolicy>& vector) {
+    VectorIoHeader header{};
+    header.magic = kVectorIoMagic;
+    header.version = kVectorIoVersion;
+    header.element_size = sizeof(T);
+    header.size = vector.Size();
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        header.encoding = static_cast<uint16_t>(VectorIoEncoding::kRaw);
+        out.WriteGathered(&header, sizeof(header), vector.begin(), vector.Size() * sizeof(T));
+    }
+    else {
+        header.encoding = static_cast<uint16_t>(VectorIoEncoding::kPerElement);
+        out.Write(&header, sizeof(header));
+        for (const T& value : vector) {
+            VectorElementIo<T>::Write(out, value);
+        }
+    }
+}
+
+// Заменяет содержимое vector прочитанными элементами. Элементы читаются порциями прямо
+// в хвост буфера, который растёт по политике роста вектора, так что повреждённый заголовок
+// с огромной длиной не выделяет память сверх пришедших данных. Если чтение прервётся
+// исключением, в векторе останутся элементы, прочитанные до ошибки
+template <typename Input, VectorSerializable T, typename Allocator, typename GrowthPolicy>
+void ReadVector(Input& in, Vector<T, Allocator, GrowthPolicy>& vector) {
+    const auto header = ReadTrivial<VectorIoHeader>(in);
+    constexpr VectorIoEncoding kEncoding
+        = std::is_trivially_copyable_v<T> ? VectorIoEncoding::kRaw : VectorIoEncoding::kPerElement;
+    if (header.magic != kVectorIoMagic || header.version != kVectorIoVersion) {
+        ThrowVectorIoError(std::errc::invalid_argument, "not a serialized vector");
+    }
+    if (header.encoding != static_cast<uint16_t>(kEncoding) || header.element_size != sizeof(T)) {
+        ThrowVectorIoError(std::errc::invalid_argument, "element type does not match");
+    }
+    if (header.size > SIZE_MAX / sizeof(T)) {
+        ThrowVectorIoError(std::errc::invalid_argument, "impossible vector size");
+    }
+    const size_t size = static_cast<size_t>(header.size);
+    constexpr size_t kBatch = std::max<size_t>(kVectorIoReadBatchBytes / sizeof(T), 1);
+    vector.Clear();
+    vector.Reserve(std::min(size, kBatch));
+    Allocator alloc = vector.GetAllocator();
+    for (size_t left = size; left != 0;) {
+        const size_t batch = std::min(left, kBatch);
+        T* tail = vector.GrowUninitialized(batch).data();
+        if constexpr (kEncoding == VectorIoEncoding::kRaw) {
+            in.Read(tail, batch * sizeof(T));
+            vector.CommitSize(batch);
+        }
+        else {
+            for (size_t i = 0; i < batch; ++i) {
+                std::allocator_traits<Allocator>::construct(alloc, tail + i, VectorElementIo<T>::Read(in));
+                vector.CommitSize(1);
+            }
+        }
+        left -= batch;
+    }
+}
+
+template <VectorSerializable T, typename Allocator, typename GrowthPolicy>
+void WriteTo(int fd, const Vector<T, Allocator, GrowthPolicy>& vector) {
+    FdOutput out(fd);
+    WriteVector(out, vector);
+    out.Flush();
+}
+
+template <VectorSerializable T, typename Allocator, typename GrowthPolicy>
+void WriteTo(std::ostream& stream, const Vector<T, Allocator, GrowthPolicy>& vector) {
+    StreamOutput out(stream);
+    WriteVector(out, vector);
+}
+
+template <VectorSerializable T, typename Allocator, typename GrowthPolicy>
+void ReadFrom(int fd, Vector<T, Allocator, GrowthPolicy>& vector) {
+    FdInput in(fd);
+    ReadVector(in, vector);
+}
+
+template <VectorSerializable T, typename Allocator, typename GrowthPolicy>
+void ReadFrom(std::istream& stream, Vector<T, Allocator, GrowthPolicy>& vector) {
+    StreamInput in(stream);
+    ReadVector(in, vector);
+}
+
+// Строка записывается длиной и символами. Символы читаются порциями, как и элементы вектора
+template <typename Char, typename Traits, typename Allocator>
+struct VectorElementIo<std::basic_string<Char, Traits, Allocator>> {
+    using String = std::basic_string<Char, Traits, Allocator>;
+
+    template <typename Output>
+    static void Write(Output& out, const String& value) {
+        WriteTrivial(out, static_cast<uint64_t>(value.size()));
+        out.Write(value.data(), value.size() * sizeof(Char));
+    }
+
+    template <typename Input>
+    static String Read(Input& in) {
+        const auto size = ReadTrivial<uint64_t>(in);
+        String value;
+        if (size > value.max_size()) {
+            ThrowVectorIoError(std::errc::invalid_argument, "impossible string size");
+        }
+        constexpr size_t kBatch = std::max<size_t>(kVectorIoReadBatchBytes / sizeof(Char), 1);
+        while (value.size() < size) {
+            const size_t old_size = value.size();
+            value.resize(old_size + std::min(static_cast<size_t>(size) - old_size, kBatch));
+            in.Read(value.data() + old_size, (value.size() - old_size) * sizeof(Char));
+        }
+        return value;
+    }
+};
+
+// Вложенный вектор записывается целиком, со своим заголовком
+template <VectorSerializable T, typename Allocator, typename GrowthPolicy>
+struct VectorElementIo<Vector<T, Allocator, GrowthPolicy>> {
+    template <typename Output>
+    static void Write(Output& out, const Vector<T, Allocator, GrowthPolicy>& value) {
+        WriteVector(out, value);
+    }
+
+    template <typename Input>
+    static Vector<T, Allocator, GrowthPolicy> Read(Input& in) {
+        Vector<T, Allocator, GrowthPolicy> value;
+        ReadVector(in, value);
+        return value;
+    }
+};
\ No newline at end of file
@@ -0,0 +1,137 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <type_traits>
+
+// Параллельное создание, копирование и уничтожение элементов очень больших векторов.
+// Работа делится на непрерывные части, каждая выполняется в своём потоке. Кроме ускорения это
+// распределяет первое касание страниц между потоками, и на многопроцессорных машинах буфер
+// ложится на несколько NUMA-узлов. По умолчанию режим выключен и включается SetParallelThreshold
+
+class ParallelSettings {
+public:
+    // Векторы от threshold_bytes байт обрабатываются max_threads потоками
+    // (0 — по числу аппаратных потоков). SIZE_MAX выключает параллельный режим
+    static void SetThreshold(size_t threshold_bytes, unsigned max_threads = 0) noexcept {
+        threshold_bytes_.store(threshold_bytes, std::memory_order_relaxed);
+        max_threads_.store(max_threads, std::memory_order_relaxed);
+    }
+
+    // Число частей для работы над bytes байтами; 1 означает выполнение в текущем потоке
+    static size_t ChunkCount(size_t bytes) noexcept {
+        if (bytes < threshold_bytes_.load(std::memory_order_relaxed)) {
+            return 1;
+        }
+        size_t threads = max_threads_.load(std::memory_order_relaxed);
+        if (threads == 0) {
+            threads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+        // Слишком мелкие части не окупают создание потока
+        return std::clamp<size_t>(bytes / kMinChunkBytes, 1, threads);
+    }
+
+private:
+    static constexpr size_t kMinChunkBytes = size_t{1} << 20;
+
+    static inline std::atomic<size_t> threshold_bytes_{SIZE_MAX};
+    static inline std::atomic<unsigned> max_threads_{0};
+};
+
+inline void SetParallelThreshold(size_t threshold_bytes, unsigned max_threads = 0) noexcept {
+    ParallelSettings::SetThreshold(threshold_bytes, max_threads);
+}
+
+// Начало части chunk при делении count элементов на chunk_count почти равных частей
+inline size_t ChunkBegin(size_t count, size_t chunk_count, size_t chunk) noexcept {
+    return count / chunk_count * chunk + std::min(chunk, count % chunk_count);
+}
+
+// Вызывает body(first, last) для каждой из chunk_count частей [0, count): нулевую в текущем потоке,
+// остальные в новых. Если поток создать не удалось, его часть выполняется в текущем.
+// Возвращает исключения частей; пустой exception_ptr означает, что часть выполнена успешно
+template <typename Body>
+std::unique_ptr<std::exception_ptr[]> RunInChunks(size_t count, size_t chunk_count, Body body) {
+    auto errors = std::make_unique<std::exception_ptr[]>(chunk_count);
+    auto threads = std::make_unique<std::thread[]>(chunk_count);
+    auto run = [&](size_t chunk) noexcept {
+        try {
+            body(ChunkBegin(count, chunk_count, chunk), ChunkBegin(count, chunk_count, chunk + 1));
+        }
+        catch (...) {
+            errors[chunk] = std::current_exception();
+        }
+    };
+    for (size_t chunk = 1; chunk < chunk_count; ++chunk) {
+        try {
+            threads[chunk] = std::thread(run, chunk);
+        }
+        catch (...) {
+            run(chunk);
+        }
+    }
+    run(0);
+    for (size_t chunk = 1; chunk < chunk_count; ++chunk) {
+        if (threads[chunk].joinable()) {
+            threads[chunk].join();
+        }
+    }
+    return errors;
+}
+
+// Создаёт count элементов в неинициализированной памяти to, вызывая construct(to + first, last - first)
+// для каждой части. construct сам уничтожает созданное при исключении. Если какая-то часть
+// не удалась, успешно созданные части уничтожаются и исключение пробрасывается дальше
+template <typename T, typename Construct>
+void ConstructInChunks(T* to, size_t count, Construct construct) {
+    const size_t chunk_count = ParallelSettings::ChunkCount(count * sizeof(T));
+    if (chunk_count == 1) {
+        construct(to, count);
+        return;
+    }
+    const auto errors = RunInChunks(count, chunk_count, [&](size_t first, size_t last) {
+        construct(to + first, last - first);
+    });
+    for (size_t failed = 0; failed < chunk_count; ++failed) {
+        if (errors[failed] == nullptr) {
+            continue;
+        }
+        for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+            if (errors[chunk] == nullptr) {
+                const size_t first = ChunkBegin(count, chunk_count, chunk);
+                std::destroy_n(to + first, ChunkBegin(count, chunk_count, chunk + 1) - first);
+            }
+        }
+        std::rethrow_exception(errors[failed]);
+    }
+}
+
+// Уничтожает count элементов, начиная с first, деля работу между потоками для больших диапазонов.
+// При вычислении на этапе компиляции потоков нет, и элементы уничтожаются последовательно
+template <typename T>
+constexpr void DestroyInChunks(T* first, size_t count) noexcept {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+        if (std::is_constant_evaluated()) {
+            std::destroy_n(first, count);
+            return;
+        }
+        const size_t chunk_count = ParallelSettings::ChunkCount(count * sizeof(T));
+        if (chunk_count == 1) {
+            std::destroy_n(first, count);
+            return;
+        }
+        try {
+            RunInChunks(count, chunk_count, [first](size_t begin, size_t end) noexcept {
+                std::destroy_n(first + begin, end - begin);
+            });
+        }
+        catch (...) {
+            // Не хватило памяти на служебные массивы, и ни одна часть ещё не начата
+            std::destroy_n(first, count);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,817 @@
+#pragma once
+#include "vector.h"
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define VECTOR_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+// Векторизованные поиск и свёртки над непрерывными массивами чисел: Find, Count, Contains, MinMax,
+// Sum и Dot. Для int32_t, float и uint64_t на x86 есть реализации на SSE2, AVX2 и AVX-512,
+// нужная выбирается во время выполнения по возможностям процессора. Остальные арифметические
+// типы и другие архитектуры обрабатываются скалярным кодом.
+// Суммы float считаются в нескольких независимых аккумуляторах, поэтому их округление может
+// отличаться от последовательного сложения. Результат MinMax на массивах с NaN не определён
+
+enum class SimdLevel {
+    kScalar,
+    kSse2,
+    kAvx2,
+    kAvx512,
+};
+
+// Тип результата Sum и Dot: целые накапливаются в 64 битах, вещественные — в исходном типе
+template <typename T>
+using SimdSumType = std::conditional_t<std::is_floating_point_v<T>, T,
+                                       std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>>;
+
+inline SimdLevel DetectSimdLevel() noexcept {
+#ifdef VECTOR_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return SimdLevel::kAvx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdLevel::kAvx2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return SimdLevel::kSse2;
+    }
+#endif
+    return SimdLevel::kScalar;
+}
+
+class SimdDispatch {
+public:
+    static SimdLevel Active() noexcept {
+        return Level().load(std::memory_order_relaxed);
+    }
+
+    // Ограничивает используемый набор инструкций, например чтобы сравнить реализации в бенчмарке.
+    // Уровень выше поддерживаемого процессором понижается до доступного
+    static void Limit(SimdLevel level) noexcept {
+        Level().store(std::min(level, DetectSimdLevel()), std::memory_order_relaxed);
+    }
+
+private:
+    static std::atomic<SimdLevel>& Level() noexcept {
+        static std::atomic<SimdLevel> level{DetectSimdLevel()};
+        return level;
+    }
+};
+
+// Набор операций над регистрами уровня Level для элементов T. Операции, которых нет в наборе
+// инструкций (например, сравнения 64-битных целых в SSE2), просто отсутствуют, и ядро
+// выполняет такую работу скалярно.
+// Регистры передаются только по ссылке, а результат записывается в первый аргумент:
+// передача __m256/__m512 по значению между функциями с разными target меняет ABI,
+// и без оптимизации, когда ядро не встраивается в точку входа, результат был бы неверным
+template <SimdLevel Level, typename T>
+struct SimdOps {};
+
+#ifdef VECTOR_SIMD_X86
+
+// Интринсики AVX-512 в GCC 12 инициализируют неопределённые регистры сами собой,
+// и -Wmaybe-uninitialized ложно срабатывает на каждое их встраивание
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+template <>
+struct SimdOps<SimdLevel::kSse2, int32_t> {
+    using Reg = __m128i;
+    using Acc = __m128i;
+    static constexpr size_t kLanes = 4;
+    static constexpr size_t kAccLanes = 2;
+
+    [[gnu::target("sse2")]] static void Load(Reg& v, const int32_t* p) noexcept {
+        v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+
+    [[gnu::target("sse2")]] static void Store(int32_t* p, const Reg& v) noexcept {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+    }
+
+    [[gnu::target("sse2")]] static void Set1(Reg& v, int32_t value) noexcept {
+        v = _mm_set1_epi32(value);
+    }
+
+    [[gnu::target("sse2")]] static uint64_t EqualMask(const int32_t* p, const Reg& needle) noexcept {
+        const Reg equal = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), needle);
+        return static_cast<uint64_t>(_mm_movemask_ps(_mm_castsi128_ps(equal)));
+    }
+
+    // В SSE2 нет pminsd/pmaxsd, поэтому выбор делается по маске сравнения
+    [[gnu::target("sse2")]] static void Min(Reg& low, const int32_t* p) noexcept {
+        const Reg v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const Reg greater = _mm_cmpgt_epi32(low, v);
+        low = _mm_or_si128(_mm_and_si128(greater, v), _mm_andnot_si128(greater, low));
+    }
+
+    [[gnu::target("sse2")]] static void Max(Reg& high, const int32_t* p) noexcept {
+        const Reg v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const Reg greater = _mm_cmpgt_epi32(v, high);
+        high = _mm_or_si128(_mm_and_si128(greater, v), _mm_andnot_si128(greater, high));
+    }
+
+    [[gnu::target("sse2")]] static void AccZero(Acc& acc) noexcept {
+        acc = _mm_setzero_si128();
+    }
+
+    // Расширяет элементы до 64 бит знаком из арифметического сдвига
+    [[gnu::target("sse2")]] static void AccAdd(Acc& acc, const int32_t* p) noexcept {
+        const Reg v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const Reg sign = _mm_srai_epi32(v, 31);
+        acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(v, sign));
+        acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(v, sign));
+    }
+
+    [[gnu::target("sse2")]] static void AccStore(int64_t* p, const Acc& acc) noexcept {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p), acc);
+    }
+};
+
+template <>
+struct SimdOps<SimdLevel::kSse2, float> {
+    using Reg = __m128;
+    using Acc = __m128;
+    static constexpr size_t kLanes = 4;
+    static constexpr size_t kAccLanes = 4;
+
+    [[gnu::target("sse2")]] static void Load(Reg& v, const float* p) noexcept {
+        v = _mm_loadu_ps(p);
+    }
+
+    [[gnu::target("sse2")]] static void Store(float* p, const Reg& v) noexcept {
+        _mm_storeu_ps(p, v);
+    }
+
+    [[gnu::target("sse2")]] static void Set1(Reg& v, float value) noexcept {
+        v = _mm_set1_ps(value);
+    }
+
+    [[gnu::target("sse2")]] static uint64_t EqualMask(const float* p, const Reg& needle) noexcept {
+        return static_cast<uint64_t>(_mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(p), needle)));
+    }
+
+    [[gnu::target("sse2")]] static void Min(Reg& low, const float* p) noexcept {
+        low = _mm_min_ps(low, _mm_loadu_ps(p));
+    }
+
+    [[gnu::target("sse2")]] static void Max(Reg& high, const float* p) noexcept {
+        high = _mm_max_ps(high, _mm_loadu_ps(p));
+    }
+
+    [[gnu::target("sse2")]] static void AccZero(Acc& acc) noexcept {
+        acc = _mm_setzero_ps();
+    }
+
+    [[gnu::target("sse2")]] static void AccAdd(Acc& acc, const float* p) noexcept {
+        acc = _mm_add_ps(acc, _mm_loadu_ps(p));
+    }
+
+    [[gnu::target("sse2")]] static void AccMulAdd(Acc& acc, const float* a, const float* b) noexcept {
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(a), _mm_loadu_ps(b)));
+    }
+
+    [[gnu::target("sse2")]] static void AccStore(float* p, const Acc& acc) noexcept {
+        _mm_storeu_ps(p, acc);
+    }
+};
+
+template <>
+struct SimdOps<SimdLevel::kSse2, uint64_t> {
+    using Reg = __m128i;
+    using Acc = __m128i;
+    static constexpr size_t kLanes = 2;
+    static constexpr size_t kAccLanes = 2;
+
+    [[gnu::target("sse2")]] static void Load(Reg& v, const uint64_t* p) noexcept {
+        v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+
+    [[gnu::target("sse2")]] static void Store(uint64_t* p, const Reg& v) noexcept {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+    }
+
+    [[gnu::target("sse2")]] static void Set1(Reg& v, uint64_t value) noexcept {
+        v = _mm_set1_epi64x(static_cast<long long>(value));
+    }
+
+    // pcmpeqq появилась только в SSE4.1: 64-битные половины равны, когда равны обе 32-битные
+    [[gnu::target("sse2")]] static uint64_t EqualMask(const uint64_t* p, const Reg& needle) noexcept {
+        const Reg halves = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), needle);
+        const Reg both = _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+        return static_cast<uint64_t>(_mm_movemask_pd(_mm_castsi128_pd(both)));
+    }
+
+    [[gnu::target("sse2")]] static void AccZero(Acc& acc) noexcept {
+        acc = _mm_setzero_si128();
+    }
+
+    [[gnu::target("sse2")]] static void AccAdd(Acc& acc, const uint64_t* p) noexcept {
+        acc = _mm_add_epi64(acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+    }
+
+    // Младшие 64 бита произведения из трёх умножений 32x32->64
+    [[gnu::target("sse2")]] static void AccMulAdd(Acc& acc, const uint64_t* a, const uint64_t* b) noexcept {
+        const Reg x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+        const Reg y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+        const Reg low = _mm_mul_epu32(x, y);
+        const Reg cross = _mm_add_epi64(_mm_mul_epu32(_mm_srli_epi64(x, 32), y), _mm_mul_epu32(x, _mm_srli_epi64(y, 32)));
+        acc = _mm_add_epi64(acc, _mm_add_epi64(low, _mm_slli_epi64(cross, 32)));
+    }
+
+    [[gnu::target("sse2")]] static void AccStore(uint64_t* p, const Acc& acc) noexcept {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p), acc);
+    }
+};
+
+template <>
+struct SimdOps<SimdLevel::kAvx2, int32_t> {
+    using Reg = __m256i;
+    using Acc = __m256i;
+    static constexpr size_t kLanes = 8;
+    static constexpr size_t kAccLanes = 4;
+
+    [[gnu::target("avx2")]] static void Load(Reg& v, const int32_t* p) noexcept {
+        v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+
+    [[gnu::target("avx2")]] static void Store(int32_t* p, const Reg& v) noexcept {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+    }
+
+    [[gnu::target("avx2")]] static void Set1(Reg& v, int32_t value) noexcept {
+        v = _mm256_set1_epi32(value);
+    }
+
+    [[gnu::target("avx2")]] static uint64_t EqualMask(const int32_t* p, const Reg& needle) noexcept {
+        const Reg equal = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), needle);
+        return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(equal)));
+    }
+
+    [[gnu::target("avx2")]] static void Min(Reg& low, const int32_t* p) noexcept {
+        low = _mm256_min_epi32(low, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+    }
+
+    [[gnu::target("avx2")]] static void Max(Reg& high, const int32_t* p) noexcept {
+        high = _mm256_max_epi32(high, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+    }
+
+    [[gnu::target("avx2")]] static void AccZero(Acc& acc) noexcept {
+        acc = _mm256_setzero_si256();
+    }
+
+    [[gnu::target("avx2")]] static void AccAdd(Acc& acc, const int32_t* p) noexcept {
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))));
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 4))));
+    }
+
+    // vpmuldq перемножает со знаком младшие 32 бита 64-битных половин: сначала чётные
+    // элементы, затем нечётные, сдвинутые на место чётных
+    [[gnu::target("avx2")]] static void AccMulAdd(Acc& acc, const int32_t* a, const int32_t* b) noexcept {
+        const Reg x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+        const Reg y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+        acc = _mm256_add_epi64(acc, _mm256_mul_epi32(x, y));
+        acc = _mm256_add_epi64(acc, _mm256_mul_epi32(_mm256_srli_epi64(x, 32), _mm256_srli_epi64(y, 32)));
+    }
+
+    [[gnu::target("avx2")]] static void AccStore(int64_t* p, const Acc& acc) noexcept {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), acc);
+    }
+};
+
+template <>
+struct SimdOps<SimdLevel::kAvx2, float> {
+    using Reg = __m256;
+    using Acc = __m256;
+    static constexpr size_t kLanes = 8;
+    static constexpr size_t kAccLanes = 8;
+
+    [[gnu::target("avx2")]] static void Load(Reg& v, const float* p) noexcept {
+        v = _mm256_loadu_ps(p);
+    }
+
+    [[gnu::target("avx2")]] static void Store(float* p, const Reg& v) noexcept {
+        _mm256_storeu_ps(p, v);
+    }
+
+    [[gnu::target("avx2")]] static void Set1(Reg& v, float value) noexcept {
+        v = _mm256_set1_ps(value);
+    }
+
+    [[gnu::target("avx2")]] static uint64_t EqualMask(const float* p, const Reg& needle) noexcept {
+        return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(p), needle, _CMP_EQ_OQ)));
+    }
+
+    [[gnu::target("avx2")]] static void Min(Reg& low, const float* p) noexcept {
+        low = _mm256_min_ps(low, _mm256_loadu_ps(p));
+    }
+
+    [[gnu::target("avx2")]] static void Max(Reg& high, const float* p) noexcept {
+        high = _mm256_max_ps(high, _mm256_loadu_ps(p));
+    }
+
+    [[gnu::target("avx2")]] static void AccZero(Acc& acc) noexcept {
+        acc = _mm256_setzero_ps();
+    }
+
+    [[gnu::target("avx2")]] static void AccAdd(Acc& acc, const float* p) noexcept {
+        acc = _mm256_add_ps(acc, _mm256_loadu_ps(p));
+    }
+
+    [[gnu::target("avx2")]] static void AccMulAdd(Acc& acc, const float* a, const float* b) noexcept {
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(a), _mm256_loadu_ps(b)));
+    }
+
+    [[gnu::target("avx2")]] static void AccStore(float* p, const Acc& acc) noexcept {
+        _mm256_storeu_ps(p, acc);
+    }
+};
+
+template <>
+struct SimdOps<SimdLevel::kAvx2, uint64_t> {
+    using Reg = __m256i;
+    using Acc = __m256i;
+    static constexpr size_t kLanes = 4;
+    static constexpr size_t kAccLanes = 4;
+
+    [[gnu::target("avx2")]] static void Load(Reg& v, const uint64_t* p) noexcept {
+        v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+
+    [[gnu::target("avx2")]] static void Store(uint64_t* p, const Reg& v) noexcept {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+    }
+
+    [[gnu::target("avx2")]] static void Set1(Reg& v, uint64_t value) noexcept {
+        v = _mm256_set1_epi64x(static_cast<long long>(value));
+    }
+
+    [[gnu::target("avx2")]] static uint64_t EqualMask(const uint64_t* p, const Reg& needle) noexcept {
+        const Reg equal = _mm256_cmpeq_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), needle);
+        return static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(equal)));
+    }
+
+    // В AVX2 есть только знаковое сравнение 64-битных целых: инвертированный старший бит
+    // превращает его в беззнаковое
+    [[gnu::target("avx2")]] static void Min(Reg& low, const uint64_t* p) noexcept {
+        const Reg v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        low = _mm256_blendv_epi8(low, v, Greater(low, v));
+    }
+
+    [[gnu::target("avx2")]] static void Max(Reg& high, const uint64_t* p) noexcept {
+        const Reg v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        high = _mm256_blendv_epi8(high, v, Greater(v, high));
+    }
+
+    [[gnu::target("avx2")]] static void AccZero(Acc& acc) noexcept {
+        acc = _mm256_setzero_si256();
+    }
+
+    [[gnu::target("avx2")]] static void AccAdd(Acc& acc, const uint64_t* p) noexcept {
+        acc = _mm256_add_epi64(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+    }
+
+    [[gnu::target("avx2")]] static void AccMulAdd(Acc& acc, const uint64_t* a, const uint64_t* b) noexcept {
+        const Reg x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+        const Reg y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+        const Reg low = _mm256_mul_epu32(x, y);
+        const Reg cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(x, 32), y),
+                                           _mm256_mul_epu32(x, _mm256_srli_epi64(y, 32)));
+        acc = _mm256_add_epi64(acc, _mm256_add_epi64(low, _mm256_slli_epi64(cross, 32)));
+    }
+
+    [[gnu::target("avx2")]] static void AccStore(uint64_t* p, const Acc& acc) noexcept {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), acc);
+    }
+
+private:
+    // Вызывается только из функций с тем же target, поэтому регистры передаются по значению
+    [[gnu::target("avx2")]] static Reg Greater(Reg a, Reg b) noexcept {
+        const Reg sign = _mm256_set1_epi64x(INT64_MIN);
+        return _mm256_cmpgt_epi64(_mm256_xor_si256(a, sign), _mm256_xor_si256(b, sign));
+    }
+};
+
+template <>
+struct SimdOps<SimdLevel::kAvx512, int32_t> {
+    using Reg = __m512i;
+    using Acc = __m512i;
+    static constexpr size_t kLanes = 16;
+    static constexpr size_t kAccLanes = 8;
+
+    [[gnu::target("avx512f")]] static void Load(Reg& v, const int32_t* p) noexcept {
+        v = _mm512_loadu_si512(p);
+    }
+
+    [[gnu::target("avx512f")]] static void Store(int32_t* p, const Reg& v) noexcept {
+        _mm512_storeu_si512(p, v);
+    }
+
+    [[gnu::target("avx512f")]] static void Set1(Reg& v, int32_t value) noexcept {
+        v = _mm512_set1_epi32(value);
+    }
+
+    [[gnu::target("avx512f")]] static uint64_t EqualMask(const int32_t* p, const Reg& needle) noexcept {
+        return _mm512_cmpeq_epi32_mask(_mm512_loadu_si512(p), needle);
+    }
+
+    [[gnu::target("avx512f")]] static void Min(Reg& low, const int32_t* p) noexcept {
+        low = _mm512_min_epi32(low, _mm512_loadu_si512(p));
+    }
+
+    [[gnu::target("avx512f")]] static void Max(Reg& high, const int32_t* p) noexcept {
+        high = _mm512_max_epi32(high, _mm512_loadu_si512(p));
+    }
+
+    [[gnu::target("avx512f")]] static void AccZero(Acc& acc) noexcept {
+        acc = _mm512_setzero_si512();
+    }
+
+    [[gnu::target("avx512f")]] static void AccAdd(Acc& acc, const int32_t* p) noexcept {
+        acc = _mm512_add_epi64(acc, _mm512_cvtepi32_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))));
+        acc = _mm512_add_epi64(acc, _mm512_cvtepi32_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 8))));
+    }
+
+    [[gnu::target("avx512f")]] static void AccMulAdd(Acc& acc, const int32_t* a, const int32_t* b) noexcept {
+        const Reg x = _mm512_loadu_si512(a);
+        const Reg y = _mm512_loadu_si512(b);
+        acc = _mm512_add_epi64(acc, _mm512_mul_epi32(x, y));
+        acc = _mm512_add_epi64(acc, _mm512_mul_epi32(_mm512_srli_epi64(x, 32), _mm512_srli_epi64(y, 32)));
+    }
+
+    [[gnu::target("avx512f")]] static void AccStore(int64_t* p, const Acc& acc) noexcept {
+        _mm512_storeu_si512(p, acc);
+    }
+};
+
+template <>
+struct SimdOps<SimdLevel::kAvx512, float> {
+    using Reg = __m512;
+    using Acc = __m512;
+    static constexpr size_t kLanes = 16;
+    static constexpr size_t kAccLanes = 16;
+
+    [[gnu::target("avx512f")]] static void Load(Reg& v, const float* p) noexcept {
+        v = _mm512_loadu_ps(p);
+    }
+
+    [[gnu::target("avx512f")]] static void Store(float* p, const Reg& v) noexcept {
+        _mm512_storeu_ps(p, v);
+    }
+
+    [[gnu::target("avx512f")]] static void Set1(Reg& v, float value) noexcept {
+        v = _mm512_set1_ps(value);
+    }
+
+    [[gnu::target("avx512f")]] static uint64_t EqualMask(const float* p, const Reg& needle) noexcept {
+        return _mm512_cmp_ps_mask(_mm512_loadu_ps(p), needle, _CMP_EQ_OQ);
+    }
+
+    [[gnu::target("avx512f")]] static void Min(Reg& low, const float* p) noexcept {
+        low = _mm512_min_ps(low, _mm512_loadu_ps(p));
+    }
+
+    [[gnu::target("avx512f")]] static void Max(Reg& high, const float* p) noexcept {
+        high = _mm512_max_ps(high, _mm512_loadu_ps(p));
+    }
+
+    [[gnu::target("avx512f")]] static void AccZero(Acc& acc) noexcept {
+        acc = _mm512_setzero_ps();
+    }
+
+    [[gnu::target("avx512f")]] static void AccAdd(Acc& acc, const float* p) noexcept {
+        acc = _mm512_add_ps(acc, _mm512_loadu_ps(p));
+    }
+
+    [[gnu::target("avx512f")]] static void AccMulAdd(Acc& acc, const float* a, const float* b) noexcept {
+        acc = _mm512_fmadd_ps(_mm512_loadu_ps(a), _mm512_loadu_ps(b), acc);
+    }
+
+    [[gnu::target("avx512f")]] static void AccStore(float* p, const Acc& acc) noexcept {
+        _mm512_storeu_ps(p, acc);
+    }
+};
+
+template <>
+struct SimdOps<SimdLevel::kAvx512, uint64_t> {
+    using Reg = __m512i;
+    using Acc = __m512i;
+    static constexpr size_t kLanes = 8;
+    static constexpr size_t kAccLanes = 8;
+
+    [[gnu::target("avx512f")]] static void Load(Reg& v, const uint64_t* p) noexcept {
+        v = _mm512_loadu_si512(p);
+    }
+
+    [[gnu::target("avx512f")]] static void Store(uint64_t* p, const Reg& v) noexcept {
+        _mm512_storeu_si512(p, v);
+    }
+
+    [[gnu::target("avx512f")]] static void Set1(Reg& v, uint64_t value) noexcept {
+        v = _mm512_set1_epi64(static_cast<long long>(value));
+    }
+
+    [[gnu::target("avx512f")]] static uint64_t EqualMask(const uint64_t* p, const Reg& needle) noexcept {
+        return _mm512_cmpeq_epu64_mask(_mm512_loadu_si512(p), needle);
+    }
+
+    [[gnu::target("avx512f")]] static void Min(Reg& low, const uint64_t* p) noexcept {
+        low = _mm512_min_epu64(low, _mm512_loadu_si512(p));
+    }
+
+    [[gnu::target("avx512f")]] static void Max(Reg& high, const uint64_t* p) noexcept {
+        high = _mm512_max_epu64(high, _mm512_loadu_si512(p));
+    }
+
+    [[gnu::target("avx512f")]] static void AccZero(Acc& acc) noexcept {
+        acc = _mm512_setzero_si512();
+    }
+
+    [[gnu::target("avx512f")]] static void AccAdd(Acc& acc, const uint64_t* p) noexcept {
+        acc = _mm512_add_epi64(acc, _mm512_loadu_si512(p));
+    }
+
+    // vpmullq требует AVX-512DQ, поэтому произведение собирается из умножений 32x32->64
+    [[gnu::target("avx512f")]] static void AccMulAdd(Acc& acc, const uint64_t* a, const uint64_t* b) noexcept {
+        const Reg x = _mm512_loadu_si512(a);
+        const Reg y = _mm512_loadu_si512(b);
+        const Reg low = _mm512_mul_epu32(x, y);
+        const Reg cross = _mm512_add_epi64(_mm512_mul_epu32(_mm512_srli_epi64(x, 32), y),
+                                           _mm512_mul_epu32(x, _mm512_srli_epi64(y, 32)));
+        acc = _mm512_add_epi64(acc, _mm512_add_epi64(low, _mm512_slli_epi64(cross, 32)));
+    }
+
+    [[gnu::target("avx512f")]] static void AccStore(uint64_t* p, const Acc& acc) noexcept {
+        _mm512_storeu_si512(p, acc);
+    }
+};
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif
+
+// Ядра алгоритмов, общие для всех уровней. Ops = void или набор без нужных операций
+// означает скалярное выполнение; хвост, не заполняющий регистр, всегда обрабатывается скалярно
+
+struct SimdFindKernel {
+    template <typename Ops, typename T>
+    static size_t Run(const T* data, size_t size, T value) noexcept {
+        size_t i = 0;
+        if constexpr (requires(typename Ops::Reg r) { Ops::EqualMask(data, r); }) {
+            typename Ops::Reg needle;
+            Ops::Set1(needle, value);
+            for (; i + Ops::kLanes <= size; i += Ops::kLanes) {
+                if (const uint64_t mask = Ops::EqualMask(data + i, needle)) {
+                    return i + std::countr_zero(mask);
+                }
+            }
+        }
+        for (; i < size; ++i) {
+            if (data[i] == value) {
+                return i;
+            }
+        }
+        return size;
+    }
+};
+
+struct SimdCountKernel {
+    template <typename Ops, typename T>
+    static size_t Run(const T* data, size_t size, T value) noexcept {
+        size_t i = 0;
+        size_t count = 0;
+        if constexpr (requires(typename Ops::Reg r) { Ops::EqualMask(data, r); }) {
+            typename Ops::Reg needle;
+            Ops::Set1(needle, value);
+            for (; i + Ops::kLanes <= size; i += Ops::kLanes) {
+                count += std::popcount(Ops::EqualMask(data + i, needle));
+            }
+        }
+        for (; i < size; ++i) {
+            count += data[i] == value;
+        }
+        return count;
+    }
+};
+
+struct SimdMinMaxKernel {
+    template <typename Ops, typename T>
+    static std::pair<T, T> Run(const T* data, size_t size) noexcept {
+        std::pair<T, T> result{data[0], data[0]};
+        size_t i = 0;
+        if constexpr (requires(typename Ops::Reg r) { Ops::Min(r, data); }) {
+            if (size >= Ops::kLanes) {
+                typename Ops::Reg low;
+                typename Ops::Reg high;
+                Ops::Load(low, data);
+                Ops::Load(high, data);
+                for (i = Ops::kLanes; i + Ops::kLanes <= size; i += Ops::kLanes) {
+                    Ops::Min(low, data + i);
+                    Ops::Max(high, data + i);
+                }
+                T lanes[Ops::kLanes];
+                Ops::Store(lanes, low);
+                result.first = *std::min_element(lanes, lanes + Ops::kLanes);
+                Ops::Store(lanes, high);
+                result.second = *std::max_element(lanes, lanes + Ops::kLanes);
+            }
+        }
+        for (; i < size; ++i) {
+            result.first = std::min(result.first, data[i]);
+            result.second = std::max(result.second, data[i]);
+        }
+        return result;
+    }
+};
+
+// Sum и Dot ведут четыре независимых аккумулятора, чтобы задержка сложения не ограничивала
+// пропускную способность
+struct SimdSumKernel {
+    template <typename Ops, typename T>
+    static SimdSumType<T> Run(const T* data, size_t size) noexcept {
+        SimdSumType<T> sum{};
+        size_t i = 0;
+        if constexpr (requires(typename Ops::Acc acc) { Ops::AccAdd(acc, data); }) {
+            typename Ops::Acc acc[4];
+            for (auto& a : acc) {
+                Ops::AccZero(a);
+            }
+            for (; i + 4 * Ops::kLanes <= size; i += 4 * Ops::kLanes) {
+                for (size_t k = 0; k < 4; ++k) {
+                    Ops::AccAdd(acc[k], data + i + k * Ops::kLanes);
+                }
+            }
+            for (; i + Ops::kLanes <= size; i += Ops::kLanes) {
+                Ops::AccAdd(acc[0], data + i);
+            }
+            sum = ReduceAccumulators<Ops, T>(acc);
+        }
+        for (; i < size; ++i) {
+            sum += data[i];
+        }
+        return sum;
+    }
+
+    template <typename Ops, typename T>
+    static SimdSumType<T> ReduceAccumulators(const typename Ops::Acc (&acc)[4]) noexcept {
+        SimdSumType<T> lanes[4][Ops::kAccLanes];
+        for (size_t k = 0; k < 4; ++k) {
+            Ops::AccStore(lanes[k], acc[k]);
+        }
+        SimdSumType<T> sum{};
+        for (size_t lane = 0; lane < Ops::kAccLanes; ++lane) {
+            sum += (lanes[0][lane] + lanes[1][lane]) + (lanes[2][lane] + lanes[3][lane]);
+        }
+        return sum;
+    }
+};
+
+struct SimdDotKernel {
+    template <typename Ops, typename T>
+    static SimdSumType<T> Run(const T* lhs, const T* rhs, size_t size) noexcept {
+        SimdSumType<T> sum{};
+        size_t i = 0;
+        if constexpr (requires(typename Ops::Acc acc) { Ops::AccMulAdd(acc, lhs, rhs); }) {
+            typename Ops::Acc acc[4];
+            for (auto& a : acc) {
+                Ops::AccZero(a);
+            }
+            for (; i + 4 * Ops::kLanes <= size; i += 4 * Ops::kLanes) {
+                for (size_t k = 0; k < 4; ++k) {
+                    Ops::AccMulAdd(acc[k], lhs + i + k * Ops::kLanes, rhs + i + k * Ops::kLanes);
+                }
+            }
+            for (; i + Ops::kLanes <= size; i += Ops::kLanes) {
+                Ops::AccMulAdd(acc[0], lhs + i, rhs + i);
+            }
+            sum = SimdSumKernel::ReduceAccumulators<Ops, T>(acc);
+        }
+        for (; i < size; ++i) {
+            sum += static_cast<SimdSumType<T>>(lhs[i]) * static_cast<SimdSumType<T>>(rhs[i]);
+        }
+        return sum;
+    }
+};
+
+// Точки входа каждого уровня: flatten встраивает ядро и все операции над регистрами
+// в функцию, скомпилированную с нужным набором инструкций
+#ifdef VECTOR_SIMD_X86
+
+template <typename Kernel, typename T, typename... Args>
+[[gnu::target("sse2"), gnu::flatten]] auto RunSimdSse2(Args... args) noexcept {
+    return Kernel::template Run<SimdOps<SimdLevel::kSse2, T>>(args...);
+}
+
+template <typename Kernel, typename T, typename... Args>
+[[gnu::target("avx2"), gnu::flatten]] auto RunSimdAvx2(Args... args) noexcept {
+    return Kernel::template Run<SimdOps<SimdLevel::kAvx2, T>>(args...);
+}
+
+template <typename Kernel, typename T, typename... Args>
+[[gnu::target("avx512f"), gnu::flatten]] auto RunSimdAvx512(Args... args) noexcept {
+    return Kernel::template Run<SimdOps<SimdLevel::kAvx512, T>>(args...);
+}
+
+#endif
+
+template <typename Kernel, typename T, typename... Args>
+auto RunSimd(Args... args) noexcept {
+#ifdef VECTOR_SIMD_X86
+    if constexpr (std::is_same_v<T, int32_t> || std::is_same_v<T, float> || std::is_same_v<T, uint64_t>) {
+        switch (SimdDispatch::Active()) {
+            case SimdLevel::kAvx512:
+                return RunSimdAvx512<Kernel, T>(args...);
+            case SimdLevel::kAvx2:
+                return RunSimdAvx2<Kernel, T>(args...);
+            case SimdLevel::kSse2:
+                return RunSimdSse2<Kernel, T>(args...);
+            case SimdLevel::kScalar:
+                break;
+        }
+    }
+#endif
+    return Kernel::template Run<void>(args...);
+}
+
+template <typename T>
+concept SimdArithmetic = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+
+// Индекс первого элемента, равного value, или values.size(), если такого нет
+template <SimdArithmetic T>
+size_t Find(std::span<const T> values, std::type_identity_t<T> value) noexcept {
+    return RunSimd<SimdFindKernel, T>(values.data(), values.size(), value);
+}
+
+template <SimdArithmetic T>
+size_t Count(std::span<const T> values, std::type_identity_t<T> value) noexcept {
+    return RunSimd<SimdCountKernel, T>(values.data(), values.size(), value);
+}
+
+template <SimdArithmetic T>
+bool Contains(std::span<const T> values, std::type_identity_t<T> value) noexcept {
+    return Find(values, value) != values.size();
+}
+
+// Наименьший и наибольший элементы непустого диапазона
+template <SimdArithmetic T>
+std::pair<T, T> MinMax(std::span<const T> values) noexcept {
+    assert(!values.empty());
+    return RunSimd<SimdMinMaxKernel, T>(values.data(), values.size());
+}
+
+template <SimdArithmetic T>
+SimdSumType<T> Sum(std::span<const T> values) noexcept {
+    return RunSimd<SimdSumKernel, T>(values.data(), values.size());
+}
+
+// Скалярное произведение диапазонов одинаковой длины
+template <SimdArithmetic T>
+SimdSumType<T> Dot(std::span<const T> lhs, std::span<const T> rhs) noexcept {
+    assert(lhs.size() == rhs.size());
+    return RunSimd<SimdDotKernel, T>(lhs.data(), rhs.data(), lhs.size());
+}
+
+// Перегрузки для Vector, возвращающие итераторы там, где алгоритм ищет позицию
+template <SimdArithmetic T, typename Allocator, typename GrowthPolicy>
+typename Vector<T, Allocator, GrowthPolicy>::const_iterator Find(const Vector<T, Allocator, GrowthPolicy>& v,
+                                                                 std::type_identity_t<T> value) noexcept {
+    return v.begin() + Find(std::span<const T>(v.begin(), v.Size()), value);
+}
+
+template <SimdArithmetic T, typename Allocator, typename GrowthPolicy>
+size_t Count(const Vector<T, Allocator, GrowthPolicy>& v, std::type_identity_t<T> value) noexcept {
+    return Count(std::span<const T>(v.begin(), v.Size()), value);
+}
+
+template <SimdArithmetic T, typename Allocator, typename GrowthPolicy>
+bool Contains(const Vector<T, Allocator, GrowthPolicy>& v, std::type_identity_t<T> value) noexcept {
+    return Contains(std::span<const T>(v.begin(), v.Size()), value);
+}
+
+template <SimdArithmetic T, typename Allocator, typename GrowthPolicy>
+std::pair<T, T> MinMax(const Vector<T, Allocator, GrowthPolicy>& v) noexcept {
+    return MinMax(std::span<const T>(v.begin(), v.Size()));
+}
+
+template <SimdArithmetic T, typename Allocator, typename GrowthPolicy>
+SimdSumType<T> Sum(const Vector<T, Allocator, GrowthPolicy>& v) noexcept {
+    return Sum(std::span<const T>(v.begin(), v.Size()));
+}
+
+template <SimdArithmetic T, typename Allocator, typename GrowthPolicy>
+SimdSumType<T> Dot(const Vector<T, Allocator, GrowthPolicy>& lhs, const Vector<T, Allocator, GrowthPolicy>& rhs) noexcept {
+    return Dot(std::span<const T>(lhs.begin(), lhs.Size()), std::span<const T>(rhs.begin(), rhs.Size()));
+}
\ No newline at end of file
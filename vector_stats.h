@@ -0,0 +1,182 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Счётчики выделений памяти и перемещений элементов в RawMemory и Vector, раздельные для каждого
+// типа элементов. Включаются макросом VECTOR_INSTRUMENTATION; без него все Record* пусты
+// и полностью исчезают после встраивания. При вычислении на этапе компиляции события не учитываются.
+// Частые события роста подсказывают, где не хватает Reserve, а большое число скопированных
+// элементов — какому типу нужен noexcept конструктор перемещения
+
+#ifdef VECTOR_INSTRUMENTATION
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#endif
+
+struct VectorStats {
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> deallocations{0};
+    std::atomic<uint64_t> bytes_allocated{0};
+    std::atomic<uint64_t> bytes_deallocated{0};
+    // Перемещены конструктором перемещения
+    std::atomic<uint64_t> elements_moved{0};
+    // Скопированы при переносе из-за бросающего конструктора перемещения
+    std::atomic<uint64_t> elements_copied{0};
+    // Перенесены побайтово как тривиально перемещаемые
+    std::atomic<uint64_t> elements_relocated{0};
+    // Автоматические увеличения вместимости при вставке
+    std::atomic<uint64_t> growth_events{0};
+};
+
+// Реестр счётчиков всех инструментированных типов. Никогда не уничтожается, чтобы векторы
+// в статических объектах могли обновлять счётчики до самого завершения программы
+class VectorStatsRegistry {
+public:
+    static VectorStatsRegistry& Instance() {
+        static VectorStatsRegistry* instance = new VectorStatsRegistry();
+        return *instance;
+    }
+
+    VectorStats& Register(const char* mangled_type_name) {
+        std::lock_guard lock(mutex_);
+        entries_.push_back({Demangle(mangled_type_name), std::make_unique<VectorStats>()});
+        return *entries_.back().stats;
+    }
+
+    void Dump(std::ostream& out) const {
+        std::lock_guard lock(mutex_);
+        out << "type\tallocations\tdeallocations\tbytes_allocated\tbytes_deallocated"
+               "\telements_moved\telements_copied\telements_relocated\tgrowth_events\n";
+        for (const auto& [type_name, stats] : entries_) {
+            out << type_name << '\t' << stats->allocations << '\t' << stats->deallocations
+                << '\t' << stats->bytes_allocated << '\t' << stats->bytes_deallocated
+                << '\t' << stats->elements_moved << '\t' << stats->elements_copied
+                << '\t' << stats->elements_relocated << '\t' << stats->growth_events << '\n';
+        }
+    }
+
+    // Печатает счётчики в std::cerr при нормальном завершении программы
+    void DumpAtExit() {
+        std::atexit([] {
+            Instance().Dump(std::cerr);
+        });
+    }
+
+private:
+    struct Entry {
+        std::string type_name;
+        std::unique_ptr<VectorStats> stats;
+    };
+
+    static std::string Demangle(const char* mangled_type_name) {
+#if __has_include(<cxxabi.h>)
+        int status = 0;
+        std::unique_ptr<char, void (*)(void*)> demangled(
+            abi::__cxa_demangle(mangled_type_name, nullptr, nullptr, &status), std::free);
+        if (status == 0 && demangled != nullptr) {
+            return demangled.get();
+        }
+#endif
+        return mangled_type_name;
+    }
+
+    mutable std::mutex mutex_;
+    std::vector<Entry> entries_;
+};
+
+template <typename T>
+VectorStats& VectorStatsFor() {
+    static VectorStats& stats = VectorStatsRegistry::Instance().Register(typeid(T).name());
+    return stats;
+}
+
+template <typename T>
+constexpr void RecordAllocation(size_t count) noexcept {
+    if (std::is_constant_evaluated()) {
+        return;
+    }
+    VectorStats& stats = VectorStatsFor<T>();
+    stats.allocations.fetch_add(1, std::memory_order_relaxed);
+    stats.bytes_allocated.fetch_add(count * sizeof(T), std::memory_order_relaxed);
+}
+
+template <typename T>
+constexpr void RecordDeallocation(size_t count) noexcept {
+    if (std::is_constant_evaluated()) {
+        return;
+    }
+    VectorStats& stats = VectorStatsFor<T>();
+    stats.deallocations.fetch_add(1, std::memory_order_relaxed);
+    stats.bytes_deallocated.fetch_add(count * sizeof(T), std::memory_order_relaxed);
+}
+
+template <typename T>
+constexpr void RecordMoves(size_t count) noexcept {
+    if (std::is_constant_evaluated()) {
+        return;
+    }
+    VectorStatsFor<T>().elements_moved.fetch_add(count, std::memory_order_relaxed);
+}
+
+template <typename T>
+constexpr void RecordCopies(size_t count) noexcept {
+    if (std::is_constant_evaluated()) {
+        return;
+    }
+    VectorStatsFor<T>().elements_copied.fetch_add(count, std::memory_order_relaxed);
+}
+
+template <typename T>
+constexpr void RecordRelocations(size_t count) noexcept {
+    if (std::is_constant_evaluated()) {
+        return;
+    }
+    VectorStatsFor<T>().elements_relocated.fetch_add(count, std::memory_order_relaxed);
+}
+
+template <typename T>
+constexpr void RecordGrowth() noexcept {
+    if (std::is_constant_evaluated()) {
+        return;
+    }
+    VectorStatsFor<T>().growth_events.fetch_add(1, std::memory_order_relaxed);
+}
+
+#else
+
+template <typename T>
+constexpr void RecordAllocation(size_t) noexcept {
+}
+
+template <typename T>
+constexpr void RecordDeallocation(size_t) noexcept {
+}
+
+template <typename T>
+constexpr void RecordMoves(size_t) noexcept {
+}
+
+template <typename T>
+constexpr void RecordCopies(size_t) noexcept {
+}
+
+template <typename T>
+constexpr void RecordRelocations(size_t) noexcept {
+}
+
+template <typename T>
+constexpr void RecordGrowth() noexcept {
+}
+
+#endif
\ No newline at end of file